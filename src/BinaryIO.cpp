@@ -0,0 +1,18 @@
+/**
+ * @brief source file for the binary file helpers implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "BinaryIO.h"
+
+uint64_t remainingBytes(std::istream &in) {
+    std::istream::pos_type at = in.tellg();
+    if (at == std::istream::pos_type(-1) || !in.seekg(0, std::ios::end)) {
+        in.clear();
+        return UINT64_MAX;
+    }
+    std::istream::pos_type end = in.tellg();
+    in.seekg(at);
+    return end - at;
+}
@@ -0,0 +1,74 @@
+/**
+ * @brief header file for the binary file helpers of the Dendrogram and GraphSnapshot formats
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef BINARYIO_H
+#define BINARYIO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+// The binary formats are little endian. Every supported target is, so values are copied byte for byte.
+
+/**
+ * @brief write count values as they are in memory
+ * @param out binary output stream
+ * @param data first value
+ * @param count number of values
+ */
+template<typename T>
+void writeBinary(std::ostream &out, const T *data, size_t count) {
+    static_assert(std::is_trivially_copyable<T>::value, "only plain values are written byte for byte");
+    out.write(reinterpret_cast<const char *>(data), count * sizeof(T));
+}
+
+/**
+ * @brief write one value as it is in memory
+ */
+template<typename T>
+void writeBinary(std::ostream &out, const T &value) {
+    writeBinary(out, &value, 1);
+}
+
+/**
+ * @brief read one value written by writeBinary
+ * @param in binary input stream
+ * @param value receives the value
+ * @return false if the stream ended first
+ */
+template<typename T>
+bool readBinary(std::istream &in, T &value) {
+    static_assert(std::is_trivially_copyable<T>::value, "only plain values are read byte for byte");
+    return (bool) in.read(reinterpret_cast<char *>(&value), sizeof(T));
+}
+
+/**
+ * @brief copy count values out of a memory mapped file into an array and advance the read position;
+ * the caller checks that the mapping holds them
+ * @param at read position in the mapping
+ * @param array receives the values
+ * @param count number of values
+ */
+template<typename T>
+void copyBinary(const char *&at, std::vector<T> &array, size_t count) {
+    static_assert(std::is_trivially_copyable<T>::value, "only plain values are copied byte for byte");
+    array.resize(count);
+    std::memcpy(array.data(), at, count * sizeof(T));
+    at += count * sizeof(T);
+}
+
+/**
+ * @brief number of bytes left in a stream, to check the counts of a header before allocating for them
+ * @param in binary input stream, its read position is kept
+ * @return the number of bytes, UINT64_MAX if the stream cannot seek, e.g. a pipe
+ */
+uint64_t remainingBytes(std::istream &in);
+
+#endif //BINARYIO_H
@@ -0,0 +1,71 @@
+/**
+ * @brief source file for CSRGraph class implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "CSRGraph.h"
+
+CSRGraph::CSRGraph(uint32_t numVertices, const std::vector<std::pair<uint32_t, uint32_t>> &edges)
+        : n(numVertices), offsets_(numVertices + 1, 0), endpoints_(edges) {
+    // 1. count the slots of each row; a self loop takes two slots in its row like in boost
+    for (auto const &[s, t] : edges) {
+        ++this->offsets_[s + 1];
+        ++this->offsets_[t + 1];
+    }
+    for (uint32_t v = 0; v < numVertices; ++v) {
+        this->offsets_[v + 1] += this->offsets_[v];
+    }
+
+    // 2. fill the rows in edge id order
+    this->neighbors_.resize(this->offsets_[numVertices]);
+    this->edgeIds_.resize(this->offsets_[numVertices]);
+    std::vector<uint32_t> next(this->offsets_.begin(), this->offsets_.end() - 1);
+    for (uint32_t e = 0; e < edges.size(); ++e) {
+        uint32_t s = edges[e].first;
+        uint32_t t = edges[e].second;
+        this->neighbors_[next[s]] = t;
+        this->edgeIds_[next[s]++] = e;
+        this->neighbors_[next[t]] = s;
+        this->edgeIds_[next[t]++] = e;
+    }
+}
+
+uint32_t CSRGraph::aliveDegree(uint32_t v, const std::vector<char> *alive) const {
+    if (alive == nullptr) {
+        return degree(v);
+    }
+    uint32_t d = 0;
+    for (uint32_t i = this->offsets_[v]; i < this->offsets_[v + 1]; ++i) {
+        d += (*alive)[this->edgeIds_[i]] ? 1 : 0;
+    }
+    return d;
+}
+
+int CSRGraph::connectedComponents(std::vector<int> &component, const std::vector<char> *alive) const {
+    component.assign(this->n, -1);
+    std::vector<uint32_t> queue;
+    queue.reserve(this->n);
+    int count = 0;
+    for (uint32_t root = 0; root < this->n; ++root) {
+        if (component[root] >= 0) {
+            continue;
+        }
+        // BFS labelling every vertex reachable from root through alive edges
+        queue.clear();
+        queue.push_back(root);
+        component[root] = count;
+        for (size_t head = 0; head < queue.size(); ++head) {
+            uint32_t v = queue[head];
+            for (uint32_t i = this->offsets_[v]; i < this->offsets_[v + 1]; ++i) {
+                uint32_t w = this->neighbors_[i];
+                if (component[w] < 0 && (alive == nullptr || (*alive)[this->edgeIds_[i]])) {
+                    component[w] = count;
+                    queue.push_back(w);
+                }
+            }
+        }
+        ++count;
+    }
+    return count;
+}
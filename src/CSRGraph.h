@@ -0,0 +1,79 @@
+/**
+ * @brief header file for CSRGraph class declaration
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef CSRGRAPH_H
+#define CSRGRAPH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief The CSRGraph class is an immutable undirected graph in compressed sparse row form.
+ * The neighbors of vertex v are neighbors()[offsets()[v] .. offsets()[v + 1]) and the edge id of each
+ * of those slots is in the parallel edgeIds() array. Edge i of the edge list given to the constructor
+ * has id i and appears once in the row of each endpoint. Indices are 32-bit, so a graph can hold
+ * fewer than 2^31 edges.
+ *
+ * Edges are never removed from a CSRGraph. Algorithms that delete edges pass an alive mask indexed
+ * by edge id instead, where 0 marks a removed edge and a null mask means every edge is alive.
+ */
+class CSRGraph {
+private:
+    uint32_t n = 0; // number of vertices
+    std::vector<uint32_t> offsets_; // n + 1 row offsets into neighbors_ and edgeIds_
+    std::vector<uint32_t> neighbors_; // adjacent vertex of each slot
+    std::vector<uint32_t> edgeIds_; // edge id of each slot
+    std::vector<std::pair<uint32_t, uint32_t>> endpoints_; // (source, target) of each edge id
+
+public:
+    CSRGraph() : offsets_(1, 0) {}
+    /**
+     * @brief construct a CSR graph from an edge list
+     * @param numVertices number of vertices, every endpoint must be less than it
+     * @param edges (source, target) pairs, the position of an edge is its edge id
+     */
+    CSRGraph(uint32_t numVertices, const std::vector<std::pair<uint32_t, uint32_t>> &edges);
+    /**
+     * @brief adopt the arrays of a CSR graph that was built before, e.g. read from a GraphSnapshot;
+     * the arrays are not checked
+     * @param offsets n + 1 row offsets
+     * @param neighbors adjacent vertex of each slot
+     * @param edgeIds edge id of each slot
+     * @param endpoints (source, target) of each edge id
+     */
+    CSRGraph(std::vector<uint32_t> offsets, std::vector<uint32_t> neighbors, std::vector<uint32_t> edgeIds,
+             std::vector<std::pair<uint32_t, uint32_t>> endpoints)
+            : n(offsets.size() - 1), offsets_(std::move(offsets)), neighbors_(std::move(neighbors)),
+              edgeIds_(std::move(edgeIds)), endpoints_(std::move(endpoints)) {}
+
+    uint32_t numVertices() const { return n; }
+    uint32_t numEdges() const { return endpoints_.size(); }
+    uint32_t degree(uint32_t v) const { return offsets_[v + 1] - offsets_[v]; }
+    const std::vector<uint32_t> &offsets() const { return offsets_; }
+    const std::vector<uint32_t> &neighbors() const { return neighbors_; }
+    const std::vector<uint32_t> &edgeIds() const { return edgeIds_; }
+    const std::pair<uint32_t, uint32_t> &endpoints(uint32_t edgeId) const { return endpoints_[edgeId]; }
+
+    /**
+     * @brief degree of a vertex counting only alive edges (a self loop counts twice)
+     * @param v vertex
+     * @param alive alive mask indexed by edge id, nullptr if every edge is alive
+     * @return number of alive edge ends at v
+     */
+    uint32_t aliveDegree(uint32_t v, const std::vector<char> *alive) const;
+    /**
+     * @brief label the connected components using only alive edges
+     * @param component receives the component id of each vertex, ids are 0..count-1 in order of
+     *        the smallest vertex of each component
+     * @param alive alive mask indexed by edge id, nullptr if every edge is alive
+     * @return number of components
+     */
+    int connectedComponents(std::vector<int> &component, const std::vector<char> *alive = nullptr) const;
+};
+
+#endif //CSRGRAPH_H
@@ -0,0 +1,38 @@
+/**
+ * @brief source file for the command line value parsing functions implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "CommandLine.h"
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+
+uint64_t parseCount(const std::string &text, uint64_t max) {
+    // stoull skips leading spaces and accepts a sign, negative numbers wrap around
+    if (text.empty() || !std::isdigit((unsigned char) text[0])) {
+        throw std::invalid_argument(text);
+    }
+    size_t end = 0;
+    unsigned long long value = std::stoull(text, &end);
+    if (end != text.size()) {
+        throw std::invalid_argument(text);
+    }
+    if (value > max) {
+        throw std::out_of_range(text);
+    }
+    return value;
+}
+
+double parseSeconds(const std::string &text) {
+    if (text.empty() || std::isspace((unsigned char) text[0])) {
+        throw std::invalid_argument(text);
+    }
+    size_t end = 0;
+    double value = std::stod(text, &end);
+    if (end != text.size() || !(value >= 0) || std::isinf(value)) {
+        throw std::invalid_argument(text);
+    }
+    return value;
+}
@@ -0,0 +1,32 @@
+/**
+ * @brief header file for the command line value parsing functions declaration
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef COMMANDLINE_H
+#define COMMANDLINE_H
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief parse an option value that must be a whole unsigned decimal number, e.g. "--threads 4"
+ * @param text option value
+ * @param max largest accepted value
+ * @return the number
+ * @throw std::invalid_argument if the text is not only digits, e.g. "4x", "-1" or "1.5"
+ * @throw std::out_of_range if the number is above max
+ */
+uint64_t parseCount(const std::string &text, uint64_t max = UINT64_MAX);
+
+/**
+ * @brief parse an option value that must be a whole non-negative decimal number, e.g. "--time-budget 2.5"
+ * @param text option value
+ * @return the number
+ * @throw std::invalid_argument if the text is not a number, has trailing characters or is negative
+ * @throw std::out_of_range if the number does not fit in a double
+ */
+double parseSeconds(const std::string &text);
+
+#endif //COMMANDLINE_H
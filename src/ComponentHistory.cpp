@@ -0,0 +1,139 @@
+/**
+ * @brief source file for ComponentHistory class implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "ComponentHistory.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+    /**
+     * @brief root of a vertex with path halving
+     */
+    uint32_t findRoot(std::vector<uint32_t> &parent, uint32_t v) {
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    }
+}
+
+ComponentHistory::ComponentHistory(const CSRGraph &iGraph, const std::vector<uint32_t> &removalOrder,
+                                   const std::vector<size_t> &stepEnds)
+        : graph(&iGraph), order(removalOrder), stepEnd(stepEnds) {
+    uint32_t n = iGraph.numVertices();
+    uint32_t m = iGraph.numEdges();
+    size_t steps = stepEnds.size();
+    this->components.resize(steps + 1);
+    this->q.resize(steps + 1);
+
+    // union-find over the last state: every edge that is never removed is already in
+    std::vector<char> inserted(m, 1);
+    for (uint32_t e : removalOrder) {
+        inserted[e] = 0;
+    }
+    std::vector<uint32_t> parent(n);
+    std::iota(parent.begin(), parent.end(), 0);
+    std::vector<uint32_t> size(n, 1);
+    std::vector<uint32_t> nextMember(n); // circular list of the members of each component
+    std::iota(nextMember.begin(), nextMember.end(), 0);
+    std::vector<uint32_t> node(n); // dendrogram node of each root
+    std::iota(node.begin(), node.end(), 0);
+    std::vector<uint64_t> degreeSum(n); // d_c of each root
+
+    // L = sum of L_c, D = sum of d_c^2, Q = L / m - D / 4m^2
+    uint64_t internal = 0;
+    uint64_t squares = 0;
+    for (uint32_t v = 0; v < n; ++v) {
+        degreeSum[v] = iGraph.degree(v);
+        squares += degreeSum[v] * degreeSum[v];
+    }
+    for (uint32_t e = 0; e < m; ++e) {
+        auto const &[u, v] = iGraph.endpoints(e);
+        internal += u == v;
+    }
+    uint32_t count = n;
+    const std::vector<uint32_t> &offsets = iGraph.offsets();
+    const std::vector<uint32_t> &neighbors = iGraph.neighbors();
+
+    // merge the components of u and v; L grows by the edges of the whole graph between them, found by
+    // scanning the smaller component, so every vertex is scanned O(log n) times in total
+    auto unite = [&](uint32_t u, uint32_t v, uint32_t step) {
+        uint32_t a = findRoot(parent, u);
+        uint32_t b = findRoot(parent, v);
+        if (a == b) {
+            return;
+        }
+        if (size[a] > size[b]) {
+            std::swap(a, b);
+        }
+        uint32_t member = a;
+        do {
+            for (uint32_t j = offsets[member]; j < offsets[member + 1]; ++j) {
+                if (findRoot(parent, neighbors[j]) == b) {
+                    ++internal;
+                }
+            }
+            member = nextMember[member];
+        } while (member != a);
+        squares += 2 * degreeSum[a] * degreeSum[b];
+
+        this->merge.push_back({node[a], node[b], step});
+        parent[a] = b;
+        size[b] += size[a];
+        degreeSum[b] += degreeSum[a];
+        std::swap(nextMember[a], nextMember[b]);
+        node[b] = n + this->merge.size() - 1;
+        --count;
+    };
+    auto record = [&](size_t state) {
+        this->components[state] = count;
+        this->q[state] = m == 0 ? 0 : internal / (double) m - squares / (4.0 * m * (double) m);
+    };
+
+    for (uint32_t e = 0; e < m; ++e) {
+        if (inserted[e]) {
+            auto const &[u, v] = iGraph.endpoints(e);
+            unite(u, v, steps);
+        }
+    }
+    record(steps);
+    for (size_t k = steps; k-- > 0;) {
+        for (size_t i = numRemoved(k); i < stepEnds[k]; ++i) {
+            auto const &[u, v] = iGraph.endpoints(removalOrder[i]);
+            unite(u, v, k);
+        }
+        record(k);
+    }
+}
+
+void ComponentHistory::labels(size_t state, std::vector<int> &labels) const {
+    uint32_t n = this->graph->numVertices();
+    std::vector<uint32_t> parent(n);
+    std::iota(parent.begin(), parent.end(), 0);
+    std::vector<char> removed(this->graph->numEdges(), 0);
+    for (size_t i = 0; i < numRemoved(state); ++i) {
+        removed[this->order[i]] = 1;
+    }
+    for (uint32_t e = 0; e < this->graph->numEdges(); ++e) {
+        if (!removed[e]) {
+            auto const &[u, v] = this->graph->endpoints(e);
+            uint32_t a = findRoot(parent, u);
+            uint32_t b = findRoot(parent, v);
+            parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+    // roots are the smallest vertex of their component, so they are met first
+    labels.assign(n, -1);
+    int count = 0;
+    for (uint32_t v = 0; v < n; ++v) {
+        uint32_t root = findRoot(parent, v);
+        if (labels[root] < 0) {
+            labels[root] = count++;
+        }
+        labels[v] = labels[root];
+    }
+}
@@ -0,0 +1,78 @@
+/**
+ * @brief header file for ComponentHistory class declaration
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef COMPONENTHISTORY_H
+#define COMPONENTHISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "CSRGraph.h"
+
+/**
+ * @brief The ComponentHistory class computes the connected components of a graph after every step of
+ * a known edge removal sequence, offline. The removals are replayed in reverse as union-find
+ * insertions, starting from the graph with no edges, so the whole history costs near-linear time
+ * instead of a connected components pass per step.
+ *
+ * State k is the graph after the first k steps removed their edges: state 0 is the whole graph and
+ * state numSteps() the graph with the removed edges gone. For every state the class keeps the number
+ * of components and the modularity of the components in the whole graph, and the merges of the reverse
+ * replay form the dendrogram of the splits.
+ */
+class ComponentHistory {
+public:
+    /**
+     * @brief merge of two components in the reverse replay, i.e. a split when removing edges.
+     * Dendrogram nodes 0..n-1 are the vertices and merge i creates node n + i; children always
+     * have lower node ids than their parent.
+     */
+    struct Merge {
+        uint32_t left; // dendrogram node of one side
+        uint32_t right; // dendrogram node of the other side
+        uint32_t step; // the components are apart from state step + 1 on, numSteps() if never
+    };
+
+private:
+    const CSRGraph *graph;
+    std::vector<uint32_t> order; // removed edge ids in removal order
+    std::vector<size_t> stepEnd; // end of each step in order
+    std::vector<uint32_t> components; // number of components of each state
+    std::vector<double> q; // modularity of each state
+    std::vector<Merge> merge; // merges in reverse replay order
+
+public:
+    /**
+     * @brief replay the removals and record the history
+     * @param iGraph graph the edges are removed from, must outlive the history
+     * @param removalOrder edge ids in the order they are removed, each edge at most once
+     * @param stepEnds end of each step in removalOrder, increasing; step k removes
+     *        removalOrder[stepEnds[k - 1] .. stepEnds[k])
+     */
+    ComponentHistory(const CSRGraph &iGraph, const std::vector<uint32_t> &removalOrder,
+                     const std::vector<size_t> &stepEnds);
+
+    size_t numSteps() const { return stepEnd.size(); }
+    /**
+     * @brief number of edges removed in states 0..state
+     */
+    size_t numRemoved(size_t state) const { return state == 0 ? 0 : stepEnd[state - 1]; }
+    uint32_t numComponents(size_t state) const { return components[state]; }
+    /**
+     * @brief modularity of the components of a state, evaluated in the whole graph
+     */
+    double modularity(size_t state) const { return q[state]; }
+    const std::vector<Merge> &merges() const { return merge; }
+    /**
+     * @brief label the components of a state
+     * @param state state index, 0..numSteps()
+     * @param labels receives the component of each vertex, ids are 0..count-1 in order of the
+     *        smallest vertex of each component
+     */
+    void labels(size_t state, std::vector<int> &labels) const;
+};
+
+#endif //COMPONENTHISTORY_H
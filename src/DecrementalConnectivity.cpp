@@ -0,0 +1,81 @@
+/**
+ * @brief source file for DecrementalConnectivity class implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "DecrementalConnectivity.h"
+#include <algorithm>
+
+DecrementalConnectivity::DecrementalConnectivity(const CSRGraph &iGraph, const std::vector<char> &aliveMask)
+        : graph(&iGraph), alive(&aliveMask), position(iGraph.numVertices()), mark(iGraph.numVertices(), 0) {
+    int count = iGraph.connectedComponents(this->label, &aliveMask);
+    this->member.resize(count);
+    for (uint32_t v = 0; v < iGraph.numVertices(); ++v) {
+        this->position[v] = this->member[this->label[v]].size();
+        this->member[this->label[v]].push_back(v);
+    }
+}
+
+bool DecrementalConnectivity::deleteEdge(uint32_t edge) {
+    auto const &[u, v] = this->graph->endpoints(edge);
+    if (u == v) {
+        return false;
+    }
+    // fresh marks for the two searches, clear the array when the stamps wrap around
+    if (this->stamp >= UINT32_MAX - 2) {
+        std::fill(this->mark.begin(), this->mark.end(), 0);
+        this->stamp = 0;
+    }
+    this->stamp += 2;
+    uint32_t roots[2] = {u, v};
+    size_t head[2] = {0, 0};
+    for (int side = 0; side < 2; ++side) {
+        this->queue[side].clear();
+        this->queue[side].push_back(roots[side]);
+        this->mark[roots[side]] = this->stamp + side;
+    }
+
+    const std::vector<uint32_t> &offsets = this->graph->offsets();
+    const std::vector<uint32_t> &neighbors = this->graph->neighbors();
+    const std::vector<uint32_t> &edgeIds = this->graph->edgeIds();
+    int finished = -1; // side whose search ran out of vertices
+    for (int side = 0; finished < 0; side ^= 1) {
+        std::vector<uint32_t> &q = this->queue[side];
+        if (head[side] == q.size()) {
+            finished = side;
+            break;
+        }
+        uint32_t x = q[head[side]++];
+        for (uint32_t j = offsets[x]; j < offsets[x + 1]; ++j) {
+            if (!(*this->alive)[edgeIds[j]]) {
+                continue;
+            }
+            uint32_t w = neighbors[j];
+            if (this->mark[w] == this->stamp + (side ^ 1)) {
+                return false; // the searches met
+            }
+            if (this->mark[w] != this->stamp + side) {
+                this->mark[w] = this->stamp + side;
+                q.push_back(w);
+            }
+        }
+    }
+
+    // move the piece to a new component
+    this->piece_.swap(this->queue[finished]);
+    int old = this->label[u];
+    int created = this->member.size();
+    this->member.emplace_back();
+    std::vector<uint32_t> &rest = this->member[old];
+    for (uint32_t x : this->piece_) {
+        uint32_t last = rest.back();
+        this->position[last] = this->position[x];
+        rest[this->position[x]] = last;
+        rest.pop_back();
+        this->label[x] = created;
+        this->position[x] = this->member[created].size();
+        this->member[created].push_back(x);
+    }
+    return true;
+}
@@ -0,0 +1,66 @@
+/**
+ * @brief header file for DecrementalConnectivity class declaration
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef DECREMENTALCONNECTIVITY_H
+#define DECREMENTALCONNECTIVITY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "CSRGraph.h"
+
+/**
+ * @brief The DecrementalConnectivity class keeps the connected components of a graph while its edges
+ * are deleted one at a time, in an order that is not known in advance.
+ *
+ * After an edge is deleted, a BFS runs from each endpoint, one vertex at a time in turns. If one search
+ * reaches a vertex of the other, the component did not split. If one search runs out of vertices
+ * first, the vertices it found are the new piece. Either way the cost is proportional to the smaller
+ * side, and only the vertices of the piece are moved to a new component.
+ */
+class DecrementalConnectivity {
+private:
+    const CSRGraph *graph;
+    const std::vector<char> *alive; // alive mask of the edges, owned by the caller
+    std::vector<int> label; // component of each vertex
+    std::vector<std::vector<uint32_t>> member; // vertices of each component, in no order
+    std::vector<uint32_t> position; // index of each vertex in the members of its component
+    std::vector<uint32_t> mark; // search that last reached each vertex
+    uint32_t stamp = 0; // mark of the search from the first endpoint, stamp + 1 for the second
+    std::vector<uint32_t> queue[2]; // BFS queues of the two searches, also the vertices they found
+    std::vector<uint32_t> piece_; // vertices of the last split off piece
+
+public:
+    /**
+     * @brief label the components of the graph
+     * @param iGraph graph, must outlive the structure
+     * @param aliveMask alive mask indexed by edge id, must outlive the structure; the caller clears
+     *        an entry before passing the edge to deleteEdge
+     */
+    DecrementalConnectivity(const CSRGraph &iGraph, const std::vector<char> &aliveMask);
+
+    /**
+     * @brief update the components after an edge was marked dead in the alive mask
+     * @param edge the deleted edge id
+     * @return true if the component of the edge split in two, the piece that left is then in piece()
+     */
+    bool deleteEdge(uint32_t edge);
+
+    int component(uint32_t v) const { return label[v]; }
+    int numComponents() const { return member.size(); }
+    const std::vector<int> &labels() const { return label; }
+    /**
+     * @brief vertices of a component, in no particular order
+     */
+    const std::vector<uint32_t> &members(int c) const { return member[c]; }
+    /**
+     * @brief vertices split off by the last deleteEdge that returned true, now component
+     * numComponents() - 1
+     */
+    const std::vector<uint32_t> &piece() const { return piece_; }
+};
+
+#endif //DECREMENTALCONNECTIVITY_H
@@ -0,0 +1,133 @@
+/**
+ * @brief source file for Dendrogram class implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "Dendrogram.h"
+#include "BinaryIO.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    const char magic[4] = {'G', 'N', 'D', 'G'};
+    const uint32_t formatVersion = 1;
+    const size_t readChunk = 1 << 16; // records reserved at a time when the stream size is unknown
+}
+
+Partition Dendrogram::cut(size_t index) const {
+    const Level &target = this->level[index];
+    size_t applied = this->n - target.communities; // merges inside the communities of the level
+    // label top-down: a node that is not the child of an applied merge starts a community
+    std::vector<int> nodeLabel(this->n + applied, -1);
+    int count = 0;
+    for (size_t i = applied; i-- > 0;) {
+        int &label = nodeLabel[this->n + i];
+        if (label < 0) {
+            label = count++;
+        }
+        nodeLabel[this->merge[i].left] = label;
+        nodeLabel[this->merge[i].right] = label;
+    }
+    std::vector<int> labels(nodeLabel.begin(), nodeLabel.begin() + this->n);
+    for (int &label : labels) {
+        if (label < 0) {
+            label = count++;
+        }
+    }
+    return Partition(labels, target.modularity);
+}
+
+Partition Dendrogram::cutAtCommunities(uint32_t k) const {
+    if (this->level.empty()) {
+        return Partition();
+    }
+    for (size_t i = 0; i < this->level.size(); ++i) {
+        if (this->level[i].communities >= k) {
+            return cut(i);
+        }
+    }
+    return cut(this->level.size() - 1);
+}
+
+Partition Dendrogram::cutAtModularity(float threshold) const {
+    if (this->level.empty()) {
+        return Partition();
+    }
+    for (size_t i = 0; i < this->level.size(); ++i) {
+        if (this->level[i].modularity >= threshold) {
+            return cut(i);
+        }
+    }
+    return cut(bestLevel());
+}
+
+size_t Dendrogram::bestLevel() const {
+    size_t best = 0;
+    for (size_t i = 1; i < this->level.size(); ++i) {
+        if (this->level[i].modularity > this->level[best].modularity) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+bool Dendrogram::write(std::ostream &out) const {
+    out.write(magic, sizeof(magic));
+    writeBinary(out, formatVersion);
+    writeBinary(out, this->n);
+    writeBinary(out, (uint32_t) this->level.size());
+    writeBinary(out, (uint32_t) this->merge.size());
+    for (const Level &l : this->level) {
+        writeBinary(out, l.step);
+        writeBinary(out, l.communities);
+        writeBinary(out, l.modularity);
+    }
+    for (const Merge &m : this->merge) {
+        writeBinary(out, m.left);
+        writeBinary(out, m.right);
+        writeBinary(out, m.level);
+    }
+    return (bool) out;
+}
+
+bool Dendrogram::read(std::istream &in) {
+    *this = Dendrogram();
+    char header[4];
+    uint32_t version, numVertices, numLevels, numMerges;
+    if (!in.read(header, sizeof(header)) || std::memcmp(header, magic, sizeof(magic)) != 0
+        || !readBinary(in, version) || version != formatVersion || !readBinary(in, numVertices)
+        || !readBinary(in, numLevels) || !readBinary(in, numMerges)
+        || numMerges >= std::max<uint32_t>(numVertices, 1)) {
+        return false;
+    }
+    // the counts must fit in the rest of the stream before anything is allocated for them; when its size
+    // is unknown the arrays only grow with the records actually read
+    uint64_t records = uint64_t(numLevels) + numMerges;
+    if (records * 3 * sizeof(uint32_t) > remainingBytes(in)) {
+        return false;
+    }
+    std::vector<Level> levels;
+    levels.reserve(std::min<size_t>(numLevels, readChunk));
+    for (uint32_t i = 0; i < numLevels; ++i) {
+        Level l;
+        if (!readBinary(in, l.step) || !readBinary(in, l.communities) || !readBinary(in, l.modularity)
+            || l.communities > numVertices || numVertices - l.communities > numMerges) {
+            return false;
+        }
+        levels.push_back(l);
+    }
+    std::vector<Merge> merges;
+    merges.reserve(std::min<size_t>(numMerges, readChunk));
+    for (uint32_t i = 0; i < numMerges; ++i) {
+        Merge m;
+        // children are created before their parent
+        if (!readBinary(in, m.left) || !readBinary(in, m.right) || !readBinary(in, m.level)
+            || m.left >= numVertices + i || m.right >= numVertices + i) {
+            return false;
+        }
+        merges.push_back(m);
+    }
+    *this = Dendrogram(numVertices, std::move(levels), std::move(merges));
+    return true;
+}
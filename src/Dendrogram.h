@@ -0,0 +1,100 @@
+/**
+ * @brief header file for Dendrogram class declaration
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef DENDROGRAM_H
+#define DENDROGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "Partition.h"
+#include <algorithm>
+#include <utility>
+
+/**
+ * @brief The Dendrogram class is the hierarchy of splits of a divisive community detection run.
+ *
+ * A level is a partition the run went through: level 0 is the components of the whole graph and every
+ * following level has more communities. The tree is stored bottom-up as merges: nodes 0..n-1 are the
+ * vertices and merge i joins two nodes into node n + i. Merges are ordered from the finest level to
+ * the coarsest, so the partition of a level is given by its first n - communities merges and any level
+ * can be cut in O(n) without recomputing betweeness.
+ */
+class Dendrogram {
+public:
+    struct Level {
+        uint32_t step; // number of edge removal steps the run took to reach the level
+        uint32_t communities; // number of communities
+        float modularity; // modularity of the level in the original graph
+    };
+    struct Merge {
+        uint32_t left; // node of one side
+        uint32_t right; // node of the other side
+        uint32_t level; // the sides are apart from this level on, numLevels() if never
+    };
+
+private:
+    uint32_t n = 0; // number of vertices
+    std::vector<Level> level;
+    std::vector<Merge> merge;
+
+public:
+    Dendrogram() = default;
+    /**
+     * @brief constructor
+     * @param numVertices number of vertices
+     * @param levels levels from the coarsest to the finest
+     * @param merges merges from the finest level to the coarsest, i.e. with non-increasing level
+     */
+    Dendrogram(uint32_t numVertices, std::vector<Level> levels, std::vector<Merge> merges)
+            : n(numVertices), level(std::move(levels)), merge(std::move(merges)) {}
+
+    uint32_t numVertices() const { return n; }
+    size_t numLevels() const { return level.size(); }
+    const std::vector<Level> &levels() const { return level; }
+    const std::vector<Merge> &merges() const { return merge; }
+
+    /**
+     * @brief partition of one level, in O(n)
+     * @param index level index, 0..numLevels()-1
+     * @return the communities of the level and its modularity
+     */
+    Partition cut(size_t index) const;
+    /**
+     * @brief cut at the first level with at least k communities, or the finest level if none has k
+     * @return the partition, empty if the dendrogram has no level
+     */
+    Partition cutAtCommunities(uint32_t k) const;
+    /**
+     * @brief cut at the coarsest level whose modularity reaches a threshold, or the level with the
+     * highest modularity if none does
+     * @return the partition, empty if the dendrogram has no level
+     */
+    Partition cutAtModularity(float threshold) const;
+    /**
+     * @brief index of the first level with the highest modularity
+     */
+    size_t bestLevel() const;
+
+    /**
+     * @brief write the dendrogram in binary form: the magic "GNDG", then the format version, n, the
+     * number of levels and the number of merges as 32-bit words, the levels as (step, communities,
+     * modularity) and the merges as (left, right, level), all 32-bit little endian
+     * @param out binary output stream
+     * @return true if every byte was written
+     */
+    bool write(std::ostream &out) const;
+    /**
+     * @brief read a dendrogram written by write; counts that do not fit in the rest of the stream are
+     * rejected before anything is allocated for them
+     * @param in binary input stream
+     * @return true if the stream held a valid dendrogram, the dendrogram is left empty otherwise
+     */
+    bool read(std::istream &in);
+};
+
+#endif //DENDROGRAM_H
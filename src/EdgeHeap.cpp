@@ -0,0 +1,96 @@
+/**
+ * @brief source file for EdgeHeap class implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "EdgeHeap.h"
+
+void EdgeHeap::build(const std::vector<float> &edgeKeys, const std::vector<char> &mask) {
+    this->keys = edgeKeys;
+    this->position.assign(edgeKeys.size(), -1);
+    this->heap.clear();
+    for (uint32_t e = 0; e < edgeKeys.size(); ++e) {
+        if (mask[e]) {
+            this->position[e] = this->heap.size();
+            this->heap.push_back(e);
+        }
+    }
+    // bottom-up heapify
+    for (size_t i = this->heap.size() / 2; i-- > 0;) {
+        siftDown(i);
+    }
+}
+
+void EdgeHeap::update(uint32_t edge, float key) {
+    if (this->position[edge] < 0) {
+        this->keys[edge] = key;
+        this->heap.push_back(edge);
+        this->position[edge] = this->heap.size() - 1;
+        siftUp(this->heap.size() - 1);
+        return;
+    }
+    float old = this->keys[edge];
+    this->keys[edge] = key;
+    if (key > old) {
+        siftUp(this->position[edge]);
+    } else if (key < old) {
+        siftDown(this->position[edge]);
+    }
+}
+
+void EdgeHeap::remove(uint32_t edge) {
+    int64_t index = this->position[edge];
+    if (index < 0) {
+        return;
+    }
+    uint32_t last = this->heap.back();
+    this->heap.pop_back();
+    this->position[edge] = -1;
+    if (last == edge) {
+        return;
+    }
+    // move the last edge into the hole and restore the order in whichever direction it is broken
+    place(index, last);
+    siftUp(index);
+    siftDown(this->position[last]);
+}
+
+uint32_t EdgeHeap::pop() {
+    uint32_t edge = this->heap.front();
+    remove(edge);
+    return edge;
+}
+
+void EdgeHeap::siftUp(size_t index) {
+    uint32_t edge = this->heap[index];
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!before(edge, this->heap[parent])) {
+            break;
+        }
+        place(index, this->heap[parent]);
+        index = parent;
+    }
+    place(index, edge);
+}
+
+void EdgeHeap::siftDown(size_t index) {
+    uint32_t edge = this->heap[index];
+    size_t size = this->heap.size();
+    while (true) {
+        size_t child = 2 * index + 1;
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && before(this->heap[child + 1], this->heap[child])) {
+            ++child;
+        }
+        if (!before(this->heap[child], edge)) {
+            break;
+        }
+        place(index, this->heap[child]);
+        index = child;
+    }
+    place(index, edge);
+}
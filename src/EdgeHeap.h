@@ -0,0 +1,77 @@
+/**
+ * @brief header file for EdgeHeap class declaration
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef EDGEHEAP_H
+#define EDGEHEAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief The EdgeHeap class is an indexed binary max-heap of edge ids keyed by betweeness.
+ * The position of every edge id in the heap is tracked, so the key of any edge can be raised or
+ * lowered and any edge removed in O(log m). Equal keys are ordered by the lower edge id first,
+ * so the removal order does not depend on float ties.
+ */
+class EdgeHeap {
+private:
+    std::vector<uint32_t> heap; // edge ids in heap order
+    std::vector<int64_t> position; // index of each edge id in heap, -1 if absent
+    std::vector<float> keys; // key of each edge id
+
+    /**
+     * @brief heap order: higher key first, lower edge id first on equal keys
+     */
+    bool before(uint32_t a, uint32_t b) const {
+        return keys[a] > keys[b] || (keys[a] == keys[b] && a < b);
+    }
+    void place(size_t index, uint32_t edge) {
+        heap[index] = edge;
+        position[edge] = index;
+    }
+    void siftUp(size_t index);
+    void siftDown(size_t index);
+
+public:
+    /**
+     * @brief construct an empty heap
+     * @param numEdges number of edge ids, ids are 0..numEdges-1
+     */
+    explicit EdgeHeap(uint32_t numEdges = 0) : position(numEdges, -1), keys(numEdges, 0) {}
+
+    /**
+     * @brief replace the content of the heap with every edge that has a non-zero mask entry, in O(m)
+     * @param edgeKeys key of each edge id
+     * @param mask edges with a 0 entry are left out
+     */
+    void build(const std::vector<float> &edgeKeys, const std::vector<char> &mask);
+    /**
+     * @brief insert an edge, or move it to its new place if it is already in the heap
+     * @param edge edge id
+     * @param key new key of the edge
+     */
+    void update(uint32_t edge, float key);
+    /**
+     * @brief remove an edge if it is in the heap
+     * @param edge edge id
+     */
+    void remove(uint32_t edge);
+    /**
+     * @brief remove the edge with the highest key
+     * @return the removed edge id
+     */
+    uint32_t pop();
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    bool contains(uint32_t edge) const { return position[edge] >= 0; }
+    uint32_t top() const { return heap.front(); }
+    float topKey() const { return keys[heap.front()]; }
+    float key(uint32_t edge) const { return keys[edge]; }
+};
+
+#endif //EDGEHEAP_H
@@ -0,0 +1,177 @@
+/**
+ * @brief source file for EdgeListFile class implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "EdgeListFile.h"
+#include "ParallelFor.h"
+#include "TextFile.h"
+#include <algorithm>
+#include <charconv>
+#include <unordered_map>
+
+namespace {
+    /**
+     * @brief strip spaces (and the carriage return of CRLF files) from both ends
+     */
+    std::string_view trim(std::string_view s) {
+        size_t first = s.find_first_not_of(" \r");
+        if (first == std::string_view::npos) {
+            return std::string_view();
+        }
+        size_t last = s.find_last_not_of(" \r");
+        return s.substr(first, last - first + 1);
+    }
+}
+
+void EdgeListFile::setNumThreads(unsigned int threads) {
+    this->numThreads = resolveThreads(threads);
+}
+
+bool EdgeListFile::load(const std::string &path) {
+    return readTextFile(path, [&](std::string_view text) { parse(text); });
+}
+
+bool EdgeListFile::load(std::istream &in) {
+    return readTextStream(in, [&](std::string_view text) { parse(text); });
+}
+
+void EdgeListFile::parseChunk(std::string_view text, size_t numShards, Chunk &chunk) {
+    std::unordered_map<std::string_view, uint32_t> index;
+    chunk.byShard.resize(numShards);
+    auto intern = [&](std::string_view name) {
+        auto [it, inserted] = index.try_emplace(name, chunk.names.size());
+        if (inserted) {
+            if (numShards > 1) {
+                chunk.byShard[std::hash<std::string_view>()(name) % numShards].push_back(chunk.names.size());
+            }
+            chunk.names.push_back(name);
+        }
+        return it->second;
+    };
+    while (!text.empty()) {
+        std::string_view line = nextLine(text);
+        // names may hold a '-' when the separator is " - "
+        size_t width = 3;
+        size_t dash = line.find(" - ");
+        if (dash == std::string_view::npos) {
+            width = 1;
+            dash = line.find('-');
+        }
+        if (dash == std::string_view::npos) {
+            continue; // not an edge
+        }
+        std::string_view source = trim(line.substr(0, dash));
+        std::string_view target = trim(line.substr(dash + width));
+        if (source.empty() || target.empty()) {
+            continue; // a side without a name, e.g. "A -", is not an edge either
+        }
+        uint32_t u = intern(source);
+        uint32_t v = intern(target);
+        chunk.edges.emplace_back(u, v);
+    }
+}
+
+void EdgeListFile::parse(std::string_view text) {
+    this->names.clear();
+    this->edges.clear();
+
+    // the first line may give the number of edges; it is only a hint for reserving, every edge line up
+    // to the end is read. An edge line takes at least 4 bytes ("a-b\n"), which bounds a wrong hint.
+    std::string_view header = trim(text.substr(0, text.find('\n')));
+    size_t numOfEdges = 0;
+    auto [last, error] = std::from_chars(header.data(), header.data() + header.size(), numOfEdges);
+    if (error != std::errc() || last != header.data() + header.size()) {
+        numOfEdges = 0; // no header, the first line is read like the others
+    }
+    numOfEdges = std::min(numOfEdges, text.size() / 4 + 1);
+
+    // cut the text in one chunk per thread, each ending after a newline
+    std::vector<std::string_view> chunks = splitLines(text, this->numThreads);
+
+    // parse the chunks with local names, each name also goes to the shard of its hash
+    size_t numShards = this->numThreads == 1 ? 1 : this->numThreads * 4;
+    std::vector<Chunk> parsed(chunks.size());
+    parallelFor(chunks.size(), this->numThreads, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t c = begin; c < end; ++c) {
+            // share of the hint by chunk size, in double so the product cannot overflow on huge inputs
+            parsed[c].edges.reserve((size_t) ((double) numOfEdges * chunks[c].size() / text.size()));
+            parseChunk(chunks[c], numShards, parsed[c]);
+        }
+    }, 1);
+
+    if (parsed.size() == 1) {
+        // one chunk: its local ids are the global ids
+        this->edges.swap(parsed[0].edges);
+        this->names.assign(parsed[0].names.begin(), parsed[0].names.end());
+        return;
+    }
+
+    // global ids go in order of the first appearance of each name: chunk by chunk, in the local order of
+    // each chunk, so they do not depend on the threads. Every shard finds the first (chunk, local id) of
+    // its names on its own thread; local names that are not first point to their first appearance.
+    std::vector<size_t> edgeOffset(parsed.size() + 1, 0);
+    for (size_t c = 0; c < parsed.size(); ++c) {
+        parsed[c].first.assign(parsed[c].names.size(), {UINT32_MAX, 0});
+        edgeOffset[c + 1] = edgeOffset[c] + parsed[c].edges.size();
+    }
+    parallelFor(numShards, this->numThreads, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t shard = begin; shard < end; ++shard) {
+            std::unordered_map<std::string_view, std::pair<uint32_t, uint32_t>> index;
+            for (uint32_t c = 0; c < parsed.size(); ++c) {
+                for (uint32_t i : parsed[c].byShard[shard]) {
+                    auto it = index.try_emplace(parsed[c].names[i], c, i).first;
+                    if (it->second.first != c) {
+                        parsed[c].first[i] = it->second;
+                    }
+                }
+            }
+        }
+    }, 1);
+    // number the first appearances of each chunk after those of the chunks before it
+    std::vector<size_t> idOffset(parsed.size() + 1, 0);
+    for (size_t c = 0; c < parsed.size(); ++c) {
+        idOffset[c + 1] = idOffset[c];
+        for (auto const &first : parsed[c].first) {
+            idOffset[c + 1] += first.first == UINT32_MAX;
+        }
+    }
+    std::vector<std::string_view> views(idOffset.back());
+    parallelFor(parsed.size(), this->numThreads, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t c = begin; c < end; ++c) {
+            Chunk &chunk = parsed[c];
+            chunk.global.resize(chunk.names.size());
+            uint32_t id = idOffset[c];
+            for (size_t i = 0; i < chunk.names.size(); ++i) {
+                if (chunk.first[i].first == UINT32_MAX) {
+                    views[id] = chunk.names[i];
+                    chunk.global[i] = id++;
+                }
+            }
+        }
+    }, 1);
+    parallelFor(parsed.size(), this->numThreads, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t c = begin; c < end; ++c) {
+            Chunk &chunk = parsed[c];
+            for (size_t i = 0; i < chunk.names.size(); ++i) {
+                auto const &[firstChunk, firstId] = chunk.first[i];
+                if (firstChunk != UINT32_MAX) {
+                    chunk.global[i] = parsed[firstChunk].global[firstId];
+                }
+            }
+        }
+    }, 1);
+
+    this->edges.resize(edgeOffset.back());
+    parallelFor(parsed.size(), this->numThreads, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t c = begin; c < end; ++c) {
+            const std::vector<uint32_t> &global = parsed[c].global;
+            size_t k = edgeOffset[c];
+            for (auto const &[u, v] : parsed[c].edges) {
+                this->edges[k++] = {global[u], global[v]};
+            }
+        }
+    }, 1);
+    this->names.assign(views.begin(), views.end());
+}
@@ -0,0 +1,86 @@
+/**
+ * @brief header file for EdgeListFile class declaration
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef EDGELISTFILE_H
+#define EDGELISTFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief The EdgeListFile class loads a social network connection file: an optional line with the number
+ * of edges, then one "A - B" line per edge up to the end of the file. The number of edges is only used to
+ * reserve memory, so it may be missing or wrong. The file is memory mapped and tokenized in place; every
+ * name is interned as a string_view into the mapping, so a name is only copied once, when it is first
+ * seen. Pipes and other files that cannot be mapped are streamed into a buffer that grows geometrically.
+ * Vertices are numbered in order of their first appearance; lines without a '-' or with an empty name
+ * on either side are skipped. A name may hold a '-' when the names are separated by " - ".
+ *
+ * Large files are parsed on several threads: the file is cut into chunks that end after a newline, each
+ * chunk is parsed with its own name table, then the names are merged in shards by their hash, one
+ * table per shard, without locks. Ids are given in file order, so they are the same for any number of
+ * threads.
+ */
+class EdgeListFile {
+private:
+    /**
+     * @brief The Chunk struct holds the parse of one chunk of the file
+     */
+    struct Chunk {
+        std::vector<std::string_view> names; // names in order of their first appearance in the chunk
+        std::vector<std::pair<uint32_t, uint32_t>> edges; // edges in ids of names
+        std::vector<std::vector<uint32_t>> byShard; // ids of names by the shard of their hash
+        std::vector<std::pair<uint32_t, uint32_t>> first; // (chunk, id) of the first appearance of each
+                                                          // name if it is in an earlier chunk
+        std::vector<uint32_t> global; // global id of each name
+    };
+
+    unsigned int numThreads = 1;
+    std::vector<std::string> names; // name of each vertex
+    std::vector<std::pair<uint32_t, uint32_t>> edges; // (source, target) of each edge
+
+    /**
+     * @brief parse the lines of one chunk
+     * @param text whole lines
+     * @param numShards number of name shards
+     * @param chunk receives the names and edges of the lines
+     */
+    static void parseChunk(std::string_view text, size_t numShards, Chunk &chunk);
+
+public:
+    /**
+     * @brief set the number of parsing threads
+     * @param threads number of threads, 0 uses every hardware thread
+     */
+    void setNumThreads(unsigned int threads);
+    /**
+     * @brief load a file, replacing the content of the object
+     * @param path path of the file
+     * @return false if the file cannot be opened or read
+     */
+    bool load(const std::string &path);
+    /**
+     * @brief read a stream up to its end and parse it, replacing the content of the object
+     * @param in stream, e.g. std::cin
+     * @return false if reading failed
+     */
+    bool load(std::istream &in);
+    /**
+     * @brief parse the content of a file held in memory
+     * @param text content of the file
+     */
+    void parse(std::string_view text);
+
+    const std::vector<std::string> &vertexNames() const { return names; }
+    const std::vector<std::pair<uint32_t, uint32_t>> &edgeList() const { return edges; }
+};
+
+#endif //EDGELISTFILE_H
@@ -5,89 +5,566 @@
  * @version 1.0
  */
 #include "GVGraph.h"
+#include "SourceScheduler.h"
+#include "ModularityTracker.h"
+#include "ComponentHistory.h"
+#include "DecrementalConnectivity.h"
+#include "GraphSnapshot.h"
+#include <numeric>
+#include <unordered_map>
 
 GVGraph::GVGraph(vector<Edge> edgeList) {
-    set<string> vertices;
-    for (auto e : edgeList) {
-        vertices.insert(e.first);
-        vertices.insert(e.second);
+    // intern the names, then number them like the id constructor
+    std::unordered_map<string, uint32_t> ids;
+    vector<string> names;
+    vector<pair<uint32_t, uint32_t>> edges;
+    edges.reserve(edgeList.size());
+    auto intern = [&](const string &name) {
+        auto [it, inserted] = ids.try_emplace(name, names.size());
+        if (inserted) {
+            names.push_back(name);
+        }
+        return it->second;
+    };
+    for (auto const &e : edgeList) {
+        uint32_t u = intern(e.first);
+        edges.emplace_back(u, intern(e.second));
     }
-    this->g = Graph(vertices.size());
+    build(names, edges);
+}
+
+GVGraph::GVGraph(const vector<string> &names, const vector<pair<uint32_t, uint32_t>> &edges) {
+    build(names, edges);
+}
+
+GVGraph::GVGraph(CSRGraph graph, vector<string> vertexNames)
+        : csr(std::move(graph)), names(std::move(vertexNames)) {
+    this->alive.assign(this->csr.numEdges(), 1);
+    this->btw.assign(this->csr.numEdges(), 0);
+    this->_m = this->csr.numEdges();
+}
 
-    // fills the property 'vertex_name_t' of the vertices
-    set<string>::iterator it;
-    int vIndex = 0; // vertex number
-    for (it = vertices.begin(); it != vertices.end(); ++it, vIndex++) {
-        string vDescription = *it;
-        boost::put(vertex_name_t(), this->g, vIndex, vDescription);   // set the property of a vertex
-        this->indexes[vDescription] = boost::vertex(vIndex, this->g); // build map[node_description, vertex]
-        this->lookup[boost::vertex(vIndex, this->g)] = vDescription;  // build map[vertex, node_description]
+void GVGraph::build(const vector<string> &names, const vector<pair<uint32_t, uint32_t>> &edges) {
+    // number the vertices in name order
+    vector<uint32_t> byName(names.size());
+    std::iota(byName.begin(), byName.end(), 0);
+    std::sort(byName.begin(), byName.end(), [&](uint32_t a, uint32_t b) { return names[a] < names[b]; });
+    vector<uint32_t> vIndex(names.size()); // vertex number of each name id
+    this->names.reserve(names.size());
+    for (uint32_t i = 0; i < byName.size(); ++i) {
+        vIndex[byName[i]] = i;
+        this->names.push_back(names[byName[i]]);
     }
 
-    for (int i = 0; i < edgeList.size(); ++i) {
-        add_edge(this->indexes[edgeList[i].first], this->indexes[edgeList[i].second], this->g);
+    // the position of an edge in the edge list becomes its edge id
+    vector<pair<uint32_t, uint32_t>> numbered;
+    numbered.reserve(edges.size());
+    for (auto const &[u, v] : edges) {
+        numbered.emplace_back(vIndex[u], vIndex[v]);
     }
+    this->csr = CSRGraph(names.size(), numbered);
+    this->alive.assign(this->csr.numEdges(), 1);
+    this->btw.assign(this->csr.numEdges(), 0);
+    this->_m = this->csr.numEdges();
+}
+
+bool GVGraph::writeSnapshot(const string &path) const {
+    return GraphSnapshot::write(path, this->csr, this->names);
 }
 
 Graph GVGraph::computeBetweeness() {
-    typedef graph_traits<DAG>::edge_iterator edge_it;
+    updateBetweeness();
+    return toBoostGraph(&this->alive);
+}
+
+void GVGraph::updateBetweeness() {
+    this->errorBound = 0;
+    vector<uint32_t> sources(this->csr.numVertices());
+    for (uint32_t v = 0; v < sources.size(); ++v) {
+        sources[v] = v;
+    }
+    // empty the heap so the update does not sift every edge one by one
+    this->btwHeap = EdgeHeap(this->csr.numEdges());
+    updateBetweeness(sources);
+
+    // put every alive edge into the heap for later edge removal
+    this->btwHeap.build(this->btw, this->alive);
+}
+
+void GVGraph::updateBetweeness(const vector<uint32_t> &sources) {
+    uint32_t n = this->csr.numVertices();
+    // the direction-optimizing kernel needs the vertices and the edge count the BFS can reach
+    this->updateScope = &sources;
+    this->scopeDegree = 0;
+    if (this->kernel == BFSKernel::DirectionOptimizing) {
+        for (uint32_t v : sources) {
+            this->scopeDegree += this->csr.degree(v);
+        }
+    }
+    const vector<uint32_t> *active = &sources; // sources Brandes runs from
+    vector<uint32_t> sample;
+    double scale = 1.0;
+    if (this->sampleSize > 0 && this->sampleSize < sources.size()) {
+        // partial Fisher-Yates shuffle: the first k entries are a uniform sample without replacement
+        sample = sources;
+        for (size_t i = 0; i < this->sampleSize; ++i) {
+            std::uniform_int_distribution<size_t> pick(i, sample.size() - 1);
+            std::swap(sample[i], sample[pick(this->sampler)]);
+        }
+        sample.resize(this->sampleSize);
+        active = &sample;
+        scale = (double) sources.size() / this->sampleSize;
+
+        // each sampled source adds scale * delta / 2 with delta <= sources - 1, so every term lies in
+        // [0, R] with R = sources * (sources - 1) / 2; Hoeffding at 95% gives R * sqrt(ln(2 / 0.05) / 2k)
+        double range = (double) sources.size() * (sources.size() - 1) / 2.0;
+        float bound = range * std::sqrt(std::log(2.0 / 0.05) / (2.0 * this->sampleSize));
+        this->errorBound = std::max(this->errorBound, bound);
+    }
+    unsigned int threads = std::min<size_t>(this->numThreads, std::max<size_t>(active->size(), 1));
+    // workspaces and score arrays are allocated on the first update only
+    while (this->workspaces.size() < threads) {
+        this->workspaces.emplace_back(n);
+        this->threadScores.emplace_back(this->csr.numEdges(), 0);
+    }
+    while (this->kernel == BFSKernel::BitParallel && this->batchWorkspaces.size() < threads) {
+        this->batchWorkspaces.emplace_back(n);
+    }
+
+    // every credit is added in fixed point, in units of 2^-40 or coarser so that n * (n - 1), the most
+    // an edge can get, still fits in int64. Integer sums do not depend on the order of the additions, so
+    // the totals are the same for any number of threads and any stealing.
+    double pairs = std::max(1.0, (double) n * (n - 1));
+    this->scoreUnit = std::ldexp(1.0, std::min(40, (int) std::floor(62 - std::log2(pairs))));
+
+    if (threads <= 1) {
+        accumulateSources(active->data(), active->size(), 0);
+    } else if (this->kernel == BFSKernel::BitParallel) {
+        // the credits of a source depend on the other sources of its batch in the last bits, so the
+        // batches are cut from the sources as on one thread and only the batches are shared out
+        size_t width = BatchWorkspace::width;
+        parallelFor((active->size() + width - 1) / width, threads, [&](size_t begin, size_t end, unsigned int worker) {
+            for (size_t b = begin; b < end; ++b) {
+                accumulateSources(active->data() + b * width, std::min(width, active->size() - b * width), worker);
+            }
+        }, 1);
+    } else {
+        // each thread pulls sources from a work-stealing scheduler and keeps its own scores
+        // indexed by edge id, so csr is only read while the threads run
+        vector<unsigned int> ordered(active->begin(), active->end());
+        vector<uint64_t> costs;
+        sourcesByCost(ordered, costs);
+        SourceScheduler scheduler(ordered, costs, threads);
+        vector<std::thread> workers;
+        for (unsigned int t = 0; t < threads; ++t) {
+            workers.emplace_back(&GVGraph::accumulateScheduled, this, std::ref(scheduler), t);
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+    }
+
+    // reduce the per-thread scores of the edges of the sources, scale them and divide them by 2
+    const vector<uint32_t> &offsets = this->csr.offsets();
+    const vector<uint32_t> &edgeIds = this->csr.edgeIds();
+    for (uint32_t v : sources) {
+        for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+            uint32_t e = edgeIds[i];
+            if (!this->alive[e] || this->csr.endpoints(e).first != v) {
+                continue; // each edge is reduced from the row of its first endpoint
+            }
+            int64_t total = 0;
+            for (auto &scores : this->threadScores) {
+                total += scores[e];
+                scores[e] = 0;
+            }
+            this->btw[e] = total / this->scoreUnit * scale / 2.0;
+            if (this->btwHeap.contains(e)) {
+                this->btwHeap.update(e, this->btw[e]);
+            }
+        }
+    }
+}
+
+void GVGraph::sourcesByCost(vector<unsigned int> &sources, vector<uint64_t> &costs) {
+    uint32_t n = this->csr.numVertices();
+    vector<int> &component = this->sourceComponent;
+    component.resize(n, -1);
+    vector<uint64_t> componentCost;
+    vector<uint32_t> degree(n);
+
+    // label the components of the sources; a BFS from any vertex of a component scans the whole component
+    vector<uint32_t> queue;
+    for (uint32_t root : sources) {
+        if (component[root] >= 0) {
+            continue;
+        }
+        uint64_t cost = 0;
+        queue.clear();
+        queue.push_back(root);
+        component[root] = componentCost.size();
+        for (size_t head = 0; head < queue.size(); ++head) {
+            uint32_t v = queue[head];
+            degree[v] = this->csr.aliveDegree(v, &this->alive);
+            cost += 1 + degree[v];
+            for (uint32_t i = this->csr.offsets()[v]; i < this->csr.offsets()[v + 1]; ++i) {
+                uint32_t w = this->csr.neighbors()[i];
+                if (component[w] < 0 && this->alive[this->csr.edgeIds()[i]]) {
+                    component[w] = componentCost.size();
+                    queue.push_back(w);
+                }
+            }
+        }
+        componentCost.push_back(cost);
+    }
 
-    // iterate through vertices
-    for (auto vd : boost::make_iterator_range(boost::vertices(this->g))) {
-        // compute individual DAG from each vertex with betweenesses
-        DAG dag = computeDAG(vd);
-        // aggregate individual betweenesses of each DAG to g
-        edge_it ei, ei_end;
-        for (boost::tie(ei, ei_end) = edges(dag); ei != ei_end; ++ei) {
-            // find the edge in g that is the same edge as the current dag edge
-            int s = source(*ei, dag);
-            int t = target(*ei, dag);
-            auto edgeData = boost::edge(s, t, g);
-            float dagBtw = get(edge_weight_t(), dag, *ei);
-            float gBtw = get(edge_weight_t(), g, edgeData.first);
-            put(edge_weight_t(), g, edgeData.first, dagBtw + gBtw);
+    // big components first, high degree (hub) sources first inside a component
+    std::sort(sources.begin(), sources.end(), [&](unsigned int a, unsigned int b) {
+        uint64_t costA = componentCost[component[a]];
+        uint64_t costB = componentCost[component[b]];
+        if (costA != costB) {
+            return costA > costB;
         }
+        if (degree[a] != degree[b]) {
+            return degree[a] > degree[b];
+        }
+        return a < b;
+    });
+    costs.resize(sources.size());
+    for (size_t i = 0; i < sources.size(); ++i) {
+        costs[i] = componentCost[component[sources[i]]];
+    }
+    for (uint32_t v : sources) {
+        component[v] = -1;
+    }
+}
+
+void GVGraph::accumulateScheduled(SourceScheduler &scheduler, unsigned int worker) {
+    vector<unsigned int> chunk;
+    while (!pastDeadline() && scheduler.next(worker, chunk)) {
+        accumulateSources(chunk.data(), chunk.size(), worker);
     }
+}
 
-    // divide total betweenesses of each edge by 2
-    graph_traits<Graph>::edge_iterator gei, gei_end;
-    for (boost::tie(gei, gei_end) = edges(this->g); gei != gei_end; ++gei) {
-        // find weight of current edge and divide it by 2
-        float gBtw = get(edge_weight_t(), g, *gei);
-        gBtw = gBtw / 2.0;
-        put(edge_weight_t(), g, *gei, gBtw);
-        // put weight and the corresponding edge into a map for later edge removal
-        if (this->btw_map.find(gBtw) == this->btw_map.end()) {
-            this->btw_map[gBtw] = set<pair<int, int>>();
+void GVGraph::accumulateSources(const uint32_t *sources, size_t count, unsigned int worker) {
+    vector<int64_t> &scores = this->threadScores[worker];
+    if (this->kernel == BFSKernel::BitParallel) {
+        for (size_t i = 0; i < count && !pastDeadline(); i += BatchWorkspace::width) {
+            size_t size = std::min(BatchWorkspace::width, count - i);
+            accumulateBatch(sources + i, size, this->batchWorkspaces[worker], scores);
+        }
+    } else {
+        for (size_t i = 0; i < count && !pastDeadline(); ++i) {
+            accumulateBetweeness(sources[i], this->workspaces[worker], scores);
         }
-        this->btw_map[gBtw].insert(pair<int, int>(source(*gei, g), target(*gei, g)));
     }
+}
+
+void GVGraph::accumulateBetweeness(uint32_t source, BrandesWorkspace &workspace, vector<int64_t> &scores) {
+    vector<int> &distance = workspace.distance;
+    vector<double> &sigma = workspace.sigma;
+    vector<double> &delta = workspace.delta;
+    vector<uint32_t> &order = workspace.order;
+    const vector<uint32_t> &offsets = this->csr.offsets();
+    const vector<uint32_t> &neighbors = this->csr.neighbors();
+    const vector<uint32_t> &edgeIds = this->csr.edgeIds();
+    const vector<char> &isAlive = this->alive;
 
-    return g;
+    // 1. forward: BFS from the source counting shortest paths to each vertex
+    order.clear();
+    order.push_back(source);
+    distance[source] = 0;
+    sigma[source] = 1;
+    if (this->kernel == BFSKernel::DirectionOptimizing) {
+        forwardDirectionOptimizing(workspace);
+    }
+    for (size_t head = 0; this->kernel != BFSKernel::DirectionOptimizing && head < order.size(); ++head) {
+        uint32_t v = order[head];
+        for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+            if (!isAlive[edgeIds[i]]) {
+                continue;
+            }
+            uint32_t w = neighbors[i];
+            if (distance[w] < 0) {
+                distance[w] = distance[v] + 1;
+                order.push_back(w);
+            }
+            // v is a parent of w in the shortest path DAG
+            if (distance[w] == distance[v] + 1) {
+                sigma[w] += sigma[v];
+            }
+        }
+    }
+
+    // 2. backward: pop vertices farthest first and push their credit to the parents
+    for (auto it = order.rbegin(); it != order.rend(); ++it) {
+        uint32_t w = *it;
+        for (uint32_t i = offsets[w]; i < offsets[w + 1]; ++i) {
+            uint32_t v = neighbors[i];
+            if (distance[v] == distance[w] - 1 && isAlive[edgeIds[i]]) {
+                double credit = sigma[v] / sigma[w] * (1.0 + delta[w]);
+                scores[edgeIds[i]] += (int64_t) (credit * this->scoreUnit + 0.5);
+                delta[v] += credit;
+            }
+        }
+    }
+
+    // 3. reset only the vertices reached by this source
+    for (uint32_t v : order) {
+        distance[v] = -1;
+        sigma[v] = 0;
+        delta[v] = 0;
+    }
+}
+
+void GVGraph::forwardDirectionOptimizing(BrandesWorkspace &workspace) {
+    vector<int> &distance = workspace.distance;
+    vector<double> &sigma = workspace.sigma;
+    vector<uint32_t> &order = workspace.order;
+    vector<uint32_t> &unvisited = workspace.unvisited;
+    const vector<uint32_t> &offsets = this->csr.offsets();
+    const vector<uint32_t> &neighbors = this->csr.neighbors();
+    const vector<uint32_t> &edgeIds = this->csr.edgeIds();
+    const vector<char> &isAlive = this->alive;
+    const vector<uint32_t> &scope = *this->updateScope;
+
+    // edges to check from the frontier (m_f) and from the unvisited vertices (m_u), by raw degree
+    uint64_t frontierEdges = this->csr.degree(order[0]);
+    uint64_t unvisitedEdges = this->scopeDegree - frontierEdges;
+    bool bottomUp = false;
+    unvisited.clear();
+    size_t levelBegin = 0;
+    for (int d = 0; levelBegin < order.size(); ++d) {
+        size_t levelEnd = order.size();
+        // bottom-up must check every edge of an unvisited vertex to count all of its parents, so it
+        // pays off as soon as the frontier has more edges than the unvisited vertices
+        if (!bottomUp && frontierEdges > unvisitedEdges) {
+            bottomUp = true;
+            unvisited.clear();
+            for (uint32_t v : scope) {
+                if (distance[v] < 0) {
+                    unvisited.push_back(v);
+                }
+            }
+        } else if (bottomUp && (levelEnd - levelBegin) * bottomUpBeta < scope.size()) {
+            bottomUp = false;
+        }
+
+        frontierEdges = 0;
+        if (!bottomUp) {
+            // top-down: expand the frontier
+            for (size_t head = levelBegin; head < levelEnd; ++head) {
+                uint32_t v = order[head];
+                for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+                    if (!isAlive[edgeIds[i]]) {
+                        continue;
+                    }
+                    uint32_t w = neighbors[i];
+                    if (distance[w] < 0) {
+                        distance[w] = d + 1;
+                        order.push_back(w);
+                        frontierEdges += this->csr.degree(w);
+                    }
+                    if (distance[w] == d + 1) {
+                        sigma[w] += sigma[v];
+                    }
+                }
+            }
+        } else {
+            // bottom-up: every unvisited vertex sums the paths of its neighbors in the frontier
+            size_t kept = 0;
+            for (uint32_t w : unvisited) {
+                if (distance[w] >= 0) {
+                    continue; // reached by a top-down level since the list was built
+                }
+                double paths = 0;
+                for (uint32_t i = offsets[w]; i < offsets[w + 1]; ++i) {
+                    uint32_t v = neighbors[i];
+                    if (distance[v] == d && isAlive[edgeIds[i]]) {
+                        paths += sigma[v];
+                    }
+                }
+                if (paths > 0) {
+                    order.push_back(w);
+                    sigma[w] = paths;
+                    frontierEdges += this->csr.degree(w);
+                } else {
+                    unvisited[kept++] = w;
+                }
+            }
+            unvisited.resize(kept);
+            // set the distances after the sweep so new vertices are not mistaken for the frontier
+            for (size_t head = levelEnd; head < order.size(); ++head) {
+                distance[order[head]] = d + 1;
+            }
+        }
+        unvisitedEdges -= frontierEdges;
+        levelBegin = levelEnd;
+    }
+}
+
+void GVGraph::accumulateBatch(const uint32_t *sources, size_t count, BatchWorkspace &workspace,
+                              vector<int64_t> &scores) {
+    const size_t W = BatchWorkspace::width;
+    vector<uint64_t> &visited = workspace.visited;
+    vector<uint64_t> &next = workspace.next;
+    vector<int> &distance = workspace.distance;
+    vector<double> &sigma = workspace.sigma;
+    vector<double> &delta = workspace.delta;
+    vector<pair<uint32_t, uint64_t>> &reached = workspace.reached;
+    vector<size_t> &levelStart = workspace.levelStart;
+    vector<uint32_t> &touched = workspace.touched;
+    const vector<uint32_t> &offsets = this->csr.offsets();
+    const vector<uint32_t> &neighbors = this->csr.neighbors();
+    const vector<uint32_t> &edgeIds = this->csr.edgeIds();
+    const vector<char> &isAlive = this->alive;
+
+    // level 0: every source is reached by its own bit
+    reached.clear();
+    levelStart.assign(1, 0);
+    for (size_t b = 0; b < count; ++b) {
+        uint32_t s = sources[b];
+        if (visited[s] == 0) {
+            reached.emplace_back(s, 0);
+        }
+        visited[s] |= uint64_t(1) << b;
+        distance[s * W + b] = 0;
+        sigma[s * W + b] = 1;
+    }
+    for (size_t i = levelStart[0]; i < reached.size(); ++i) {
+        reached[i].second = visited[reached[i].first];
+    }
+    levelStart.push_back(reached.size());
+
+    // 1. forward: one sweep over the frontier per level for all sources of the batch
+    for (int d = 0; levelStart[d] < levelStart[d + 1]; ++d) {
+        size_t first = levelStart[d];
+        size_t last = levelStart[d + 1];
+        // 1a. sources that reach each neighbor for the first time
+        touched.clear();
+        for (size_t f = first; f < last; ++f) {
+            auto [v, frontier] = reached[f];
+            for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+                uint32_t w = neighbors[i];
+                uint64_t fresh = frontier & ~visited[w];
+                if (fresh != 0 && isAlive[edgeIds[i]]) {
+                    if (next[w] == 0) {
+                        touched.push_back(w);
+                    }
+                    next[w] |= fresh;
+                }
+            }
+        }
+        // 1b. record level d + 1
+        for (uint32_t w : touched) {
+            visited[w] |= next[w];
+            reached.emplace_back(w, next[w]);
+            for (uint64_t bits = next[w]; bits != 0; bits &= bits - 1) {
+                distance[w * W + __builtin_ctzll(bits)] = d + 1;
+            }
+        }
+        levelStart.push_back(reached.size());
+        // 1c. a frontier vertex v is a parent of w for the sources in frontier(v) & next(w)
+        for (size_t f = first; f < last; ++f) {
+            auto [v, frontier] = reached[f];
+            for (uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+                uint32_t w = neighbors[i];
+                uint64_t parentOf = frontier & next[w];
+                if (parentOf != 0 && isAlive[edgeIds[i]]) {
+                    for (; parentOf != 0; parentOf &= parentOf - 1) {
+                        size_t b = __builtin_ctzll(parentOf);
+                        sigma[w * W + b] += sigma[v * W + b];
+                    }
+                }
+            }
+        }
+        for (uint32_t w : touched) {
+            next[w] = 0;
+        }
+    }
+
+    // 2. backward: deepest level first, push the credit of each (vertex, source) to its parents
+    for (size_t d = levelStart.size() - 2; d > 0; --d) {
+        for (size_t r = levelStart[d]; r < levelStart[d + 1]; ++r) {
+            auto [w, bits] = reached[r];
+            for (uint32_t i = offsets[w]; i < offsets[w + 1]; ++i) {
+                uint32_t v = neighbors[i];
+                uint64_t candidates = bits & visited[v];
+                if (candidates == 0 || !isAlive[edgeIds[i]]) {
+                    continue;
+                }
+                for (; candidates != 0; candidates &= candidates - 1) {
+                    size_t b = __builtin_ctzll(candidates);
+                    if (distance[v * W + b] == (int) d - 1) {
+                        double credit = sigma[v * W + b] / sigma[w * W + b] * (1.0 + delta[w * W + b]);
+                        scores[edgeIds[i]] += (int64_t) (credit * this->scoreUnit + 0.5);
+                        delta[v * W + b] += credit;
+                    }
+                }
+            }
+        }
+    }
+
+    // 3. reset only the (vertex, source) pairs reached by the batch
+    for (auto [v, bits] : reached) {
+        visited[v] = 0;
+        for (; bits != 0; bits &= bits - 1) {
+            size_t b = __builtin_ctzll(bits);
+            distance[v * W + b] = -1;
+            sigma[v * W + b] = 0;
+            delta[v * W + b] = 0;
+        }
+    }
+}
+
+Graph GVGraph::toBoostGraph(const vector<char> *mask) const {
+    Graph graph(this->csr.numVertices());
+    for (uint32_t v = 0; v < this->names.size(); ++v) {
+        boost::put(vertex_name_t(), graph, v, this->names[v]); // set the property of a vertex
+    }
+    for (uint32_t e = 0; e < this->csr.numEdges(); ++e) {
+        if (mask == nullptr || (*mask)[e]) {
+            add_edge(this->csr.endpoints(e).first, this->csr.endpoints(e).second,
+                     EdgeWeight(this->btw[e], EdgeIndex(e)), graph);
+        }
+    }
+    return graph;
 }
 
 DAG GVGraph::computeDAG(Vertex start) {
     typedef graph_traits<DAG>::out_edge_iterator out_edge_it;
     typedef graph_traits<DAG>::in_edge_iterator in_edge_it;
 
+    Graph g = toBoostGraph(nullptr);
     // BFS DAG
     DAG dag = DAG(num_vertices(g));
-    // map is used to track vertices at each level
-    map<int, set<Vertex>> levelMap = map<int, set<Vertex>>();
-    levelMap[0] = set<Vertex>({start});
-    Visitor visitor(dag, start, levelMap);
+    // the visitor tracks the level of each vertex in a flat array
+    vector<int> distance(num_vertices(g), -1);
+    distance[start] = 0;
+    Visitor visitor(dag, start, distance);
 
     // 1. BFS from the starting vertex and have the visitor to construct a DAG
     boost::breadth_first_search(g, start, boost::visitor(visitor));
 
+    // bucket the reached vertices by level, in vertex order
+    vector<vector<Vertex>> levels;
+    for (Vertex v = 0; v < distance.size(); v++) {
+        if (distance[v] >= 0) {
+            if (distance[v] >= (int) levels.size()) {
+                levels.resize(distance[v] + 1);
+            }
+            levels[distance[v]].push_back(v);
+        }
+    }
+
     // 2. top-down: calculate a shortest path count for each vertex
-    for (int i = 1; i < levelMap.size(); i++) {
-        for (auto node : levelMap[i]) {
+    for (int i = 1; i < levels.size(); i++) {
+        for (auto node : levels[i]) {
             out_edge_it ei, ei_end;
             for (boost::tie(ei, ei_end) = out_edges(node, dag); ei != ei_end; ++ei) {
                 Vertex t = target(*ei, dag);
                 // skip edges in the DAG if they are on the same level
-                if (!levelMap[i].count(t)) {
+                if (distance[t] != i) {
                     // a node adds its own shortest path count to its child's existing shortest path count
                     int shortestPathCount =
                             get(boost::vertex_rank_t(), dag, t) + get(boost::vertex_rank_t(), dag, node);
@@ -98,8 +575,8 @@ DAG GVGraph::computeDAG(Vertex start) {
     }
 
     // 3. bottom-up: calculate betweeness for each edge
-    for (int i = levelMap.size() - 1; i > 0; i--) {
-        for (auto node : levelMap[i]) {
+    for (int i = levels.size() - 1; i > 0; i--) {
+        for (auto node : levels[i]) {
             // each node get a credit of 1 + sum of out edges weight
             float nodeCredit = 1;
             out_edge_it ei, ei_end;
@@ -113,7 +590,7 @@ DAG GVGraph::computeDAG(Vertex start) {
             float totalSPC = 0;
             for (boost::tie(in_ei, in_ei_end) = in_edges(node, dag); in_ei != in_ei_end; ++in_ei) {
                 Vertex parent = source(*in_ei, dag);
-                if (!levelMap[i].count(parent)) { // skip if parent is a the same level
+                if (distance[parent] != i) { // skip if parent is a the same level
                     int spc = get(vertex_rank_t(), dag, source(*in_ei, dag));
                     totalSPC += spc;
                 }
@@ -122,7 +599,7 @@ DAG GVGraph::computeDAG(Vertex start) {
             // in_edge weight = s_p_c/sum_s_p_c + credit
             for (boost::tie(in_ei, in_ei_end) = in_edges(node, dag); in_ei != in_ei_end; ++in_ei) {
                 Vertex parent = source(*in_ei, dag);
-                if (!levelMap[i].count(parent)) { // skip if parent is a the same level
+                if (distance[parent] != i) { // skip if parent is a the same level
                     int spc = get(vertex_rank_t(), dag, source(*in_ei, dag));
                     float wt = spc / totalSPC * nodeCredit;
                     put(edge_weight_t(), dag, *in_ei, wt);
@@ -135,75 +612,259 @@ DAG GVGraph::computeDAG(Vertex start) {
 }
 
 float GVGraph::computeModularity(map<int, set<int>> clusters) {
-    float B = 0;
-    // _m = num_edges(g)
-    // for each cluster in the clusters
-    set<int>::iterator it1, it2;
+    // label the clustered vertices by cluster and give every other vertex its own label
+    vector<int> labels(this->csr.numVertices(), -1);
+    int numLabels = 0;
     for (auto const &[clusterId, vertices] : clusters) {
-        for (it1 = vertices.begin(); it1 != std::prev(vertices.end()); ++it1) {
-            //   for each vertex u, get degree (ud)
-            float u_d = in_degree(*it1, g);
-            for (it2 = std::next(it1, 1); it2 != vertices.end(); it2++) {
-                // for rest of vertex v, in the component, get degree (vd)
-                float v_d = in_degree(*it2, g);
-                // probability p_vu = (vd*ud)/(2*m)
-                float p_uv = (v_d * u_d) / (2 * _m);
-                // if (v, u) is an edge of g, b_v = 1 - p_vu, else b_v = -p_vu
-                float b_uv = boost::edge(*it1, *it2, g).second ? 1.0 - p_uv : -1.0 * p_uv;
-                B = B + b_uv;
-            }
+        for (int v : vertices) {
+            labels[v] = numLabels;
+        }
+        ++numLabels;
+    }
+    for (auto &label : labels) {
+        if (label < 0) {
+            label = numLabels++;
+        }
+    }
+    return computeModularity(labels);
+}
+
+float GVGraph::computeModularity(const vector<int> &labels) {
+    uint32_t m = this->csr.numEdges();
+    if (m == 0) {
+        return 0;
+    }
+    int numLabels = labels.empty() ? 0 : *std::max_element(labels.begin(), labels.end()) + 1;
+    vector<uint64_t> internalEdges(numLabels, 0); // L_c
+    vector<uint64_t> degreeSum(numLabels, 0); // d_c
+    for (uint32_t e = 0; e < m; ++e) {
+        auto const &[u, v] = this->csr.endpoints(e);
+        if (labels[u] == labels[v]) {
+            ++internalEdges[labels[u]];
         }
+        ++degreeSum[labels[u]];
+        ++degreeSum[labels[v]];
+    }
+    double Q = 0;
+    for (int c = 0; c < numLabels; ++c) {
+        double share = degreeSum[c] / (2.0 * m);
+        Q += internalEdges[c] / (double) m - share * share;
     }
-    float Q = B / (2 * _m);
     return Q;
 }
 
-pair<Graph, float> GVGraph::detectCommunities() {
-    Graph communities;
-    typedef graph_traits<Graph>::edge_iterator edge_it_g;
+bool GVGraph::stopReached(size_t communities, size_t splitsWithoutGain,
+                          std::chrono::steady_clock::time_point start) const {
+    const StopPolicy &policy = this->stopPolicy;
+    if (policy.patience > 0 && splitsWithoutGain >= policy.patience) {
+        return true;
+    }
+    if (policy.targetCommunities > 0 && communities >= policy.targetCommunities) {
+        return true;
+    }
+    if (policy.timeBudget > 0) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() >= policy.timeBudget;
+    }
+    return false;
+}
+
+void GVGraph::startDeadline(std::chrono::steady_clock::time_point start) {
+    this->deadline = std::chrono::steady_clock::time_point::max();
+    // budgets beyond a century are as good as none and would overflow the clock
+    if (this->stopPolicy.timeBudget > 0 && this->stopPolicy.timeBudget < 3e9) {
+        this->deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(this->stopPolicy.timeBudget));
+    }
+}
+
+Partition GVGraph::detectCommunities() {
+    if (this->recompute) {
+        return detectCommunitiesRecompute();
+    }
+    auto start = std::chrono::steady_clock::now();
+    startDeadline(start);
+    // 1. compute betweenness for the graph; it stops early at the deadline
+    this->alive.assign(this->csr.numEdges(), 1);
+    updateBetweeness();
+    bool outOfTime = pastDeadline();
+    this->deadline = std::chrono::steady_clock::time_point::max();
+
+    // 2. the removal order is fixed by the initial betweeness: every step removes all edges with the
+    // highest remaining btw. A betweeness cut short by the time budget orders nothing, the run then ends
+    // with the connected components.
+    vector<uint32_t> order;
+    vector<size_t> stepEnds;
+    order.reserve(this->csr.numEdges());
+    while (!outOfTime && !this->btwHeap.empty()) {
+        float highest = this->btwHeap.topKey();
+        while (!this->btwHeap.empty() && this->btwHeap.topKey() == highest) {
+            order.push_back(this->btwHeap.pop());
+        }
+        stepEnds.push_back(order.size());
+    }
+    // a step is removed as a whole, so the removal budget ends at the last step that fits in it
+    if (this->stopPolicy.removalBudget > 0) {
+        while (!stepEnds.empty() && stepEnds.back() > this->stopPolicy.removalBudget) {
+            stepEnds.pop_back();
+        }
+        order.resize(stepEnds.empty() ? 0 : stepEnds.back());
+    }
+
+    // 3. find the clusters and their modularity in the original graph after every step at once
+    ComponentHistory history(this->csr, order, stepEnds);
+
+    // 4. take the clusters with the best modularity, the step that removes the last edge is not a split
+    size_t best = 0;
+    float modulairty = -1;
+    size_t splitsWithoutGain = 0;
+    size_t last = 0; // last state the removal went through
+    bool stopped = false;
+    while (!stopped && last < history.numSteps() && history.numRemoved(last + 1) < this->csr.numEdges()) {
+        size_t state = ++last;
+        if (history.numComponents(state) > 1 && (float) history.modularity(state) > modulairty) {
+            modulairty = history.modularity(state);
+            best = state;
+            splitsWithoutGain = 0;
+        } else if (history.numComponents(state) > history.numComponents(state - 1)) {
+            ++splitsWithoutGain;
+        }
+        stopped = stopReached(history.numComponents(state), splitsWithoutGain, start);
+    }
+    // the removal went on to the step that removes the last edge unless the policy stopped it
+    if (!stopped && last + 1 == history.numSteps()) {
+        ++last;
+    }
+    order.resize(history.numRemoved(last));
+    for (uint32_t e : order) {
+        this->alive[e] = 0;
+    }
+    _m = this->csr.numEdges() - order.size();
+
+    // 5. keep every step that split a cluster as a level of the dendrogram
+    vector<Dendrogram::Level> levels;
+    vector<uint32_t> levelOf(history.numSteps() + 2);
+    for (size_t state = 0; state <= last; ++state) {
+        if (state == 0 || history.numComponents(state) != history.numComponents(state - 1)) {
+            levels.push_back({(uint32_t) state, history.numComponents(state), (float) history.modularity(state)});
+        }
+        levelOf[state] = levels.size() - 1;
+    }
+    vector<Dendrogram::Merge> merges;
+    merges.reserve(history.merges().size());
+    for (const ComponentHistory::Merge &m : history.merges()) {
+        // sides that only split after the last state are never apart in this run
+        uint32_t level = m.step + 1 <= last ? levelOf[m.step + 1] : (uint32_t) levels.size();
+        merges.push_back({m.left, m.right, level});
+    }
+    this->dendrogram = Dendrogram(this->csr.numVertices(), std::move(levels), std::move(merges));
+
+    vector<int> communities;
+    history.labels(best, communities);
+    return Partition(communities, modulairty);
+}
+
+Partition GVGraph::detectCommunitiesRecompute() {
+    vector<int> communities; // community labels of the best split so far
     int last_num_components = 1;
     float modulairty = -1;
     float Q = -1;
+    size_t splitsWithoutGain = 0;
+    auto start = std::chrono::steady_clock::now();
+    startDeadline(start);
 
-    // 1. compute betweenness for the graph
-    this->g = computeBetweeness();
+    // 1. compute betweenness for the graph; it stops early at the deadline, which also ends the removal
+    this->alive.assign(this->csr.numEdges(), 1);
+    updateBetweeness();
+    bool outOfTime = pastDeadline();
+    size_t numAlive = this->csr.numEdges();
+    // components kept up to date after every deletion, L_c and d_c of every component updated from the
+    // piece that splits off
+    DecrementalConnectivity connectivity(this->csr, this->alive);
+    int nclusters = connectivity.numComponents();
+    ModularityTracker tracker(this->csr, connectivity.labels());
+    communities = connectivity.labels();
+    vector<uint32_t> members;
+    // levels of the dendrogram, and the (old, new) community labels of the split that starts each level
+    vector<Dendrogram::Level> levels = {{0, (uint32_t) nclusters, (float) tracker.modularity()}};
+    vector<pair<int, int>> splits = {{-1, -1}};
 
-    // 2. remove highest btw edges till the graph split
-    for (auto const &pair : this->btw_map) {
-        auto btw = pair.first;
-        // remove edges with btw
-        for (auto const &e_btw : pair.second) {
-            // if edge exist
-            if (edge(e_btw.first, e_btw.second, g).second) {
-                // remove the edge
-                remove_edge(edge(e_btw.first, e_btw.second, g).first, g);
-            }
-        }
+    size_t budget = this->stopPolicy.removalBudget;
+    while (!outOfTime && numAlive > 0 && (budget == 0 || this->csr.numEdges() - numAlive < budget)) {
+        // 2. remove the edge with the highest current betweeness (lowest id on ties)
+        uint32_t removed = this->btwHeap.pop();
+        this->alive[removed] = 0;
+        this->btw[removed] = 0;
+        --numAlive;
         // reset the _m after the edge removal
-        _m = num_edges(g);
+        _m = numAlive;
         if (_m == 0) {
             break;
         }
-        // find disconnected clusters in the graph
-        map<int, int> subClusters;
-        int nclusters = connected_components(this->g, make_assoc_property_map(subClusters));
 
-        // if number of sub cluster is more than last round, compute Q
-        if (nclusters > last_num_components) {
-            // convert subClusters to a easier data structure
-            map<int, set<int>> clusterMap = convertMap(subClusters);
+        // 3. the removal only changes the betweeness inside the component that held the edge, which may
+        // have split in two. The update pushes the new betweeness of the component's edges into the heap.
+        auto const &[u, v] = this->csr.endpoints(removed);
+        bool split = connectivity.deleteEdge(removed);
+        const vector<uint32_t> &sideOfU = connectivity.members(connectivity.component(u));
+        members.assign(sideOfU.begin(), sideOfU.end());
+        if (split) {
+            const vector<uint32_t> &sideOfV = connectivity.members(connectivity.component(v));
+            members.insert(members.end(), sideOfV.begin(), sideOfV.end());
+        }
+        // vertex order, so the sources do not depend on the history of the member lists
+        sort(members.begin(), members.end());
+        updateBetweeness(members);
 
-            // 3. calculate modularity of the components in the graph
-            Q = this->computeModularity(clusterMap);
+        // 4. a split only changes the modularity terms of the two pieces
+        if (split) {
+            ++nclusters;
+            int old = tracker.labels()[connectivity.piece()[0]];
+            int created = tracker.split(connectivity.piece().data(), connectivity.piece().size());
+            levels.push_back({(uint32_t) (this->csr.numEdges() - numAlive), (uint32_t) nclusters,
+                              (float) tracker.modularity()});
+            splits.emplace_back(old, created);
+        }
+        // if number of sub cluster is more than last round, take the new Q
+        if (nclusters > last_num_components) {
+            Q = tracker.modularity();
         }
-        // take the graph of clusters with the best modularity
+        // take the clusters with the best modularity
         if (Q > modulairty) {
-            communities = Graph();
             modulairty = Q;
-            boost::copy_graph(g, communities);
+            communities = tracker.labels();
+            splitsWithoutGain = 0;
+        } else if (split) {
+            ++splitsWithoutGain;
         }
         last_num_components = nclusters;
+        if (stopReached(nclusters, splitsWithoutGain, start)) {
+            break;
+        }
     }
+    this->deadline = std::chrono::steady_clock::time_point::max();
 
-    return pair < Graph, float > (communities, modulairty);
-}
\ No newline at end of file
+    // 5. the dendrogram bottom-up: the vertices of each final cluster are never apart, then undo the
+    // splits from the last one
+    uint32_t n = this->csr.numVertices();
+    uint32_t never = levels.size();
+    vector<Dendrogram::Merge> merges;
+    vector<int64_t> node(tracker.numCommunities(), -1); // dendrogram node of each community
+    for (uint32_t v = 0; v < n; ++v) {
+        int64_t &root = node[tracker.labels()[v]];
+        if (root >= 0) {
+            merges.push_back({(uint32_t) root, v, never});
+            root = n + merges.size() - 1;
+        } else {
+            root = v;
+        }
+    }
+    for (size_t level = splits.size(); level-- > 1;) {
+        auto const &[old, created] = splits[level];
+        merges.push_back({(uint32_t) node[old], (uint32_t) node[created], (uint32_t) level});
+        node[old] = n + merges.size() - 1;
+    }
+    this->dendrogram = Dendrogram(n, std::move(levels), std::move(merges));
+
+    return Partition(communities, modulairty);
+}
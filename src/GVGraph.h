@@ -15,24 +15,57 @@
 #include <fstream>
 #include <vector>
 #include <map>
+#include <thread>
+#include <random>
+#include <cmath>
+#include <chrono>
+#include "CSRGraph.h"
+#include "EdgeHeap.h"
+#include "Partition.h"
+#include "Dendrogram.h"
+#include "ParallelFor.h"
 
 using namespace std;
 using namespace boost;
 
 typedef std::pair<std::string, std::string> Edge;
 typedef property<vertex_name_t, std::string> VertexName;
-typedef property<edge_weight_t, float> EdgeWeight;
+typedef property<edge_index_t, int> EdgeIndex;
+typedef property<edge_weight_t, float, EdgeIndex> EdgeWeight;
 typedef adjacency_list<vecS, vecS, undirectedS, VertexName, EdgeWeight> Graph;
 typedef property<vertex_rank_t, int> VertexShortestPathCount;
 // use bidirectionalS for DAG so that in_edges() can be used.
 // direction of DAG is determined by (source, target) when an edge is added to the graph
 typedef adjacency_list<vecS, vecS, bidirectionalS, VertexShortestPathCount, EdgeWeight> DAG;
 
+class SourceScheduler;
+
+/**
+ * @brief forward (BFS) kernels of the betweeness computation
+ */
+enum class BFSKernel {
+    TopDown, // one queue based BFS per source
+    BitParallel, // 64 sources per sweep, one bit per source in per-vertex frontier masks
+    DirectionOptimizing // one BFS per source switching between top-down and bottom-up levels
+};
+
+/**
+ * @brief criteria that end the edge removal of detectCommunities before the graph runs out of edges,
+ * a criterion set to 0 is not checked
+ */
+struct StopPolicy {
+    size_t patience = 0; // stop after this many splits in a row that do not improve modularity
+    size_t targetCommunities = 0; // stop once there are at least this many communities
+    double timeBudget = 0; // stop once detectCommunities has run for this many seconds, even mid betweeness
+    size_t removalBudget = 0; // stop before removing more than this many edges
+};
+
 using Vertex = Graph::vertex_descriptor;
 using EdgeData = Graph::edge_descriptor;
 
 /**
- * @brief The GVGraph class implements Girvan-Newman algorithm using Boost Graphic Library
+ * @brief The GVGraph class implements Girvan-Newman algorithm. The analytics run on a CSRGraph;
+ * a Boost Graph of the same vertices and edges is only built on demand by toBoostGraph().
  */
 class GVGraph {
     /**
@@ -43,14 +76,14 @@ class GVGraph {
     public:
         DAG &dag; // DAG that will be created by the BFS visitor
         int rootV; // starting vertex of the DAG
-        map<int, set<Vertex>> &levelMap; // stores vertices by levels of the DAG
+        vector<int> &distance; // level of each vertex in the DAG, -1 if not reached yet
         /**
          * @brief constructor
          * @param iDag the DAG with shortest paths to be created
          * @param rootNode starting vertex of the DAG
-         * @param iMap map of vertices at each level of the DAG
+         * @param iDistance per-vertex level array, -1 everywhere except 0 at the root
          */
-        Visitor(DAG &iDag, int rootNode, map<int, set<Vertex>> &iMap) : dag(iDag), rootV(rootNode), levelMap(iMap) {}
+        Visitor(DAG &iDag, int rootNode, vector<int> &iDistance) : dag(iDag), rootV(rootNode), distance(iDistance) {}
 
         /**
          * @brief black_target is called when a vertex has been visited from its parent
@@ -63,7 +96,7 @@ class GVGraph {
             Vertex s = boost::target(e, g);
             Vertex t = boost::source(e, g);
             add_edge(s, t, 0.0, this->dag);
-            int level = 0;
+            int level;
             if (s == rootV)
             {
                 level = 1;
@@ -73,59 +106,111 @@ class GVGraph {
             }
             else
             {
-                // initialize for shortest path count to the vertex
-                int spc = boost::get(vertex_rank_t(), this->dag, t);
-                if(spc == 0){
-                    boost::put(vertex_rank_t(), this->dag, t, 0);
-                }
-                for (auto const &pair : levelMap)
-                {
-                    level = pair.first;
-                    auto vList = pair.second;
-                    if (std::find_if(vList.begin(), vList.end(), [s](const int v) { return v == s; }) != vList.end())
-                    {
-                        ++level;
-                        break;
-                    }
-                }
-            }
-            if (levelMap.find(level) == levelMap.end())
-            {
-                levelMap[level] = set<Vertex>();
-            }
-            int deleteLevel = -1;
-            for (auto const &pair : levelMap)
-            {
-                // calculate
-                auto vList = pair.second;
-                // if t is in a existing level
-                if (std::find_if(vList.begin(), vList.end(), [t](const int v) { return v == t; }) != vList.end())
-                {
-                    if (pair.first > level)
-                    { // t already exist in high level set, we need to delete it
-                        deleteLevel = pair.first;
-                        break;
-                    }
-                    else
-                    {
-                        return;
-                    }
-                }
+                // s is black, so its level is final
+                level = distance[s] + 1;
             }
-            if (deleteLevel > 0)
+            // t keeps the lowest level it can be reached from
+            if (distance[t] < 0 || distance[t] > level)
             {
-                levelMap[deleteLevel].erase(t);
+                distance[t] = level;
             }
-            levelMap[level].insert(t);
         }
     };
 
+    /**
+     * @brief The BrandesWorkspace struct holds the flat per-vertex arrays of Brandes' algorithm.
+     * It is allocated once and reused for every source, so no memory is allocated per source.
+     */
+    struct BrandesWorkspace
+    {
+        vector<int> distance; // BFS distance from the source, -1 if not reached yet
+        vector<double> sigma; // number of shortest paths from the source to each vertex
+        vector<double> delta; // dependency of the source on each vertex
+        vector<uint32_t> order; // BFS queue, read backwards as the stack of the accumulation phase
+        vector<uint32_t> unvisited; // vertices not reached yet, used by bottom-up levels
+        /**
+         * @brief constructor
+         * @param numVertices number of vertices of the graph
+         */
+        explicit BrandesWorkspace(size_t numVertices)
+                : distance(numVertices, -1), sigma(numVertices, 0), delta(numVertices, 0)
+        {
+            order.reserve(numVertices);
+        }
+    };
+
+    /**
+     * @brief The BatchWorkspace struct holds the arrays of the bit-parallel kernel for a batch of up to
+     * 64 sources. Per-source values are stored vertex-major at [v * 64 + bit], so the sources of one
+     * vertex share cache lines.
+     */
+    struct BatchWorkspace
+    {
+        static constexpr size_t width = 64; // sources per batch, one bit each
+        vector<uint64_t> visited; // sources that reached each vertex
+        vector<uint64_t> next; // sources that reach each vertex in the level being built
+        vector<int> distance; // BFS distance per (vertex, source), -1 if not reached
+        vector<double> sigma; // number of shortest paths per (vertex, source)
+        vector<double> delta; // dependency per (vertex, source)
+        vector<pair<uint32_t, uint64_t>> reached; // (vertex, sources) reaching it, grouped by level
+        vector<size_t> levelStart; // level d is reached[levelStart[d], levelStart[d + 1])
+        vector<uint32_t> touched; // vertices with a non-zero next mask
+        /**
+         * @brief constructor
+         * @param numVertices number of vertices of the graph
+         */
+        explicit BatchWorkspace(size_t numVertices)
+                : visited(numVertices, 0), next(numVertices, 0), distance(numVertices * width, -1),
+                  sigma(numVertices * width, 0), delta(numVertices * width, 0) {}
+    };
+
 private:
-    Graph g; //Represents the graph of the input connection data
-    std::map<std::string, Vertex> indexes; //key: text name of the vertex, value: number index of the vertex
-    std::map<Vertex, std::string> lookup; //key: number index of the vertex, value: text name of the vertex
-    float _m; // number of edges in g
-    std::map<float, set<pair<int, int>>, std::greater<float>> btw_map; // the betweeness of edges in decending order
+    CSRGraph csr; //Represents the graph of the input connection data
+    vector<char> alive; // alive mask of the edge ids of csr, 0 once detectCommunities removed the edge
+    vector<float> btw; // betweeness of each edge id
+    vector<string> names; // text name of each vertex; an edge list is numbered in name order
+    float _m; // number of alive edges in csr
+    unsigned int numThreads = 1; // number of threads used by computeBetweeness
+    bool recompute = false; // recompute betweeness of the affected component after every removal
+    BFSKernel kernel = BFSKernel::TopDown; // forward kernel of the betweeness computation
+    vector<BrandesWorkspace> workspaces; // one workspace per thread, reused by every betweeness update
+    vector<BatchWorkspace> batchWorkspaces; // one per thread when the bit-parallel kernel is used
+    const vector<uint32_t> *updateScope = nullptr; // whole components whose betweeness is being updated
+    uint64_t scopeDegree = 0; // sum of the degrees of updateScope, for the direction-optimizing kernel
+    static constexpr size_t bottomUpBeta = 24; // back to top-down when the frontier is below scope / beta
+    vector<vector<int64_t>> threadScores; // per-thread betweeness by edge id in scoreUnit, all 0 between updates
+    double scoreUnit = 1; // fixed point units per unit of betweeness in threadScores
+    vector<int> sourceComponent; // component scratch of sourcesByCost, all -1 between calls
+    size_t sampleSize = 0; // number of sampled sources per betweeness update, 0 for exact betweeness
+    std::mt19937_64 sampler; // source sampling generator
+    float errorBound = 0; // largest 95% confidence bound of the sampled updates since the last full update
+    EdgeHeap btwHeap; // alive edge ids by betweeness in decending order
+    Dendrogram dendrogram; // splits of the last detectCommunities run
+    StopPolicy stopPolicy; // when detectCommunities stops removing edges
+    // end of the time budget of the running detectCommunities, the betweeness workers stop taking sources
+    // after it; max() when there is no budget
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+
+    /**
+     * @brief number the vertices in name order and build the CSR graph
+     * @param names distinct name of each name id
+     * @param edges (source, target) name ids of each edge
+     */
+    void build(const vector<string> &names, const vector<pair<uint32_t, uint32_t>> &edges);
+    /**
+     * @brief check the stop policy after a removal step of detectCommunities
+     * @param communities number of communities after the step
+     * @param splitsWithoutGain splits since the best modularity so far
+     * @param start time detectCommunities started
+     * @return true if the removal should stop
+     */
+    bool stopReached(size_t communities, size_t splitsWithoutGain, std::chrono::steady_clock::time_point start) const;
+    /**
+     * @brief set the deadline from the time budget of the stop policy
+     * @param start time detectCommunities started
+     */
+    void startDeadline(std::chrono::steady_clock::time_point start);
+    bool pastDeadline() const { return std::chrono::steady_clock::now() >= this->deadline; }
 
 public:
     /**
@@ -134,34 +219,186 @@ public:
      */
     GVGraph(vector<Edge> edgeList);
     /**
-     * @brief aggregate betweeness of DAGs back to g
+     * @brief construct a graph from interned vertex names, e.g. loaded by EdgeListFile
+     * @param names distinct name of each name id
+     * @param edges (source, target) name ids of each edge
+     */
+    GVGraph(const vector<string> &names, const vector<pair<uint32_t, uint32_t>> &edges);
+    /**
+     * @brief construct a graph that was numbered before, e.g. loaded from a GraphSnapshot or from the
+     * integer ids of an IntegerGraphFile; the vertices keep their numbers
+     * @param graph CSR graph
+     * @param vertexNames name of each vertex of graph
+     */
+    GVGraph(CSRGraph graph, vector<string> vertexNames);
+    /**
+     * @brief aggregate betweeness of every source and return it on a Boost graph
      * @return graph with aggregated betweeness on edges
      */
     Graph computeBetweeness();
+    /**
+     * @brief compute the betweeness of the alive edges of csr into btw and btwHeap
+     */
+    void updateBetweeness();
+    /**
+     * @brief recompute btw for the alive edges of the given vertices only, and update their keys
+     * in btwHeap. The vertices must be whole connected components, then no other edge's betweeness
+     * depends on them.
+     * @param sources vertices of the components to recompute
+     */
+    void updateBetweeness(const vector<uint32_t> &sources);
+    /**
+     * @brief single-source step of Brandes' algorithm: BFS from the source, then walk the BFS order
+     * backwards and add the dependency carried by each shortest path edge to scores[edge id]
+     * @param source starting vertex of the BFS
+     * @param workspace reusable flat arrays, left reset for the next source on return
+     * @param scores betweenness accumulated so far in scoreUnit, indexed by edge id
+     */
+    void accumulateBetweeness(uint32_t source, BrandesWorkspace &workspace, vector<int64_t> &scores);
+    /**
+     * @brief forward phase of the direction-optimizing kernel (Beamer et al.): each level is expanded
+     * top-down from the frontier, or bottom-up by letting every unvisited vertex look for parents in
+     * the frontier when the frontier has more edges than the unvisited vertices. Shortest path counts
+     * stay exact because bottom-up sums every parent instead of stopping at the first one.
+     * @param workspace workspace whose order holds only the source, with its distance and sigma set
+     */
+    void forwardDirectionOptimizing(BrandesWorkspace &workspace);
+    /**
+     * @brief bit-parallel Brandes step for up to 64 sources. The forward phase runs the BFS of all
+     * sources in one level-synchronous sweep: each vertex carries a mask of the sources in whose
+     * frontier it is, so every adjacency row is scanned once per level for the whole batch.
+     * The backward phase walks the recorded levels bottom-up like accumulateBetweeness.
+     * @param sources first source of the batch
+     * @param count number of sources, at most BatchWorkspace::width
+     * @param workspace reusable arrays, left reset for the next batch on return
+     * @param scores betweenness accumulated so far in scoreUnit, indexed by edge id
+     */
+    void accumulateBatch(const uint32_t *sources, size_t count, BatchWorkspace &workspace, vector<int64_t> &scores);
+    /**
+     * @brief accumulate the betweeness of sources with the selected kernel into threadScores[worker]
+     * @param sources first source
+     * @param count number of sources
+     * @param worker index of the calling worker, selects its workspace
+     */
+    void accumulateSources(const uint32_t *sources, size_t count, unsigned int worker);
+    /**
+     * @brief order source vertices by estimated BFS cost: vertices of big components first,
+     * then by decreasing degree. The cost of a source is the size (vertices + edges) of its component.
+     * @param sources whole connected components, reordered most expensive first
+     * @param costs receives the estimated cost of each entry of sources
+     */
+    void sourcesByCost(vector<unsigned int> &sources, vector<uint64_t> &costs);
+    /**
+     * @brief worker loop of the parallel betweenness: accumulate the sources handed out by the scheduler
+     * into threadScores[worker] using workspaces[worker]
+     * @param scheduler work-stealing scheduler shared by the workers
+     * @param worker index of the calling worker
+     */
+    void accumulateScheduled(SourceScheduler &scheduler, unsigned int worker);
     /**
      * @brief create a DAG with shortest paths to all nodes from a start vertex using BFS
      * @param start starting vertex of the DAG
      * @return a DAG
      */
     DAG computeDAG(Vertex start);
+    /**
+     * @brief adapter from csr to a Boost graph with vertex names, edge ids and betweeness
+     * @param mask only edges with a non-zero entry are copied, nullptr copies every edge
+     * @return the Boost graph
+     */
+    Graph toBoostGraph(const vector<char> *mask) const;
     /**
      * @brief calculate modularity (Q) of a graup of clusters
-     * @param clusters
+     * @param clusters vertices of each cluster, vertices in no cluster are singletons
      * @return the Q (range from -1 to 1)
      */
     float computeModularity(map<int, set<int>> clusters);
+    /**
+     * @brief calculate modularity (Q) of a partition of the original graph in one pass over the edges:
+     * Q = sum over communities c of L_c / m - (d_c / 2m)^2, where L_c is the number of edges inside c,
+     * d_c the sum of the degrees of its vertices and m the number of edges
+     * @param labels community label of each vertex, labels are 0..number of communities - 1
+     * @return the Q (range from -1/2 to 1)
+     */
+    float computeModularity(const vector<int> &labels);
     /**
      * @brief 1. remove edges with highest betweeness
      *        2. if removal creates new clusters, calculate modularity of the clusters
-     *        3. track the graph with highest modularity
+     *        3. track the labels of the clusters with highest modularity
      *        4. stop if there are no more edges in g, otherwise repeat 1
-     * @return the graph of sub-clusters with highest modularity identified in the process
+     * The removal order only depends on the initial betweeness, so the clusters of every step are
+     * found at once by replaying the removals in reverse (see ComponentHistory).
+     * In recompute mode the edge with the highest current betweeness is removed one at a time and
+     * the betweeness of the component it belonged to is recomputed after each removal.
+     * @return the partition into sub-clusters with highest modularity identified in the process
+     */
+    Partition detectCommunities();
+    /**
+     * @brief recompute mode of detectCommunities: remove the highest betweeness edge, then recompute
+     * the betweeness of the component it was in
+     * @return the partition into sub-clusters with highest modularity identified in the process
+     */
+    Partition detectCommunitiesRecompute();
+    /**
+     * @brief set whether detectCommunities recomputes betweeness after every edge removal
+     * (Girvan-Newman as published) instead of removing edges in the order of the initial betweeness
+     * @param enabled true to recompute
+     */
+    void setRecomputeBetweeness(bool enabled) { recompute = enabled; }
+    /**
+     * @brief set when detectCommunities stops removing edges; the best split found up to then is
+     * returned and the dendrogram ends there
+     * @param policy the stopping criteria, the default policy removes every edge
+     */
+    void setStopPolicy(const StopPolicy &policy) { stopPolicy = policy; }
+    /**
+     * @brief select the forward kernel of the betweeness computation
+     * @param bfsKernel the kernel
      */
-    pair<Graph, float> detectCommunities();
+    void setBFSKernel(BFSKernel bfsKernel) { kernel = bfsKernel; }
+    /**
+     * @brief approximate betweeness by running Brandes from k uniformly sampled sources of each
+     * update (without replacement) and scaling the scores by sources / k. Used by computeBetweeness
+     * and detectCommunities; k = 0 or k >= number of sources computes exact betweeness.
+     * @param k number of sampled sources
+     * @param seed seed of the sampling generator
+     */
+    void setBetweenessSampling(size_t k, uint64_t seed = 5489) {
+        sampleSize = k;
+        sampler.seed(seed);
+    }
+    /**
+     * @brief absolute error bound of the sampled betweeness: with 95% confidence the betweeness of
+     * an edge is within this distance of the exact value (Hoeffding's inequality, which also holds
+     * for sampling without replacement). 0 when the last updates were exact.
+     * @return the bound
+     */
+    float getBetweenessErrorBound() { return errorBound; }
 
     ~GVGraph() {}
-    Graph getGraph() { return g; } //return the original graph
-    string node_name(int vertexIndex) { return lookup[vertexIndex]; }
+    /**
+     * @brief set the number of threads computeBetweeness splits the source vertices over
+     * @param threads number of threads, 0 means one per hardware thread
+     */
+    void setNumThreads(unsigned int threads) {
+        numThreads = resolveThreads(threads);
+    }
+    unsigned int getNumThreads() { return numThreads; }
+    /**
+     * @brief the hierarchy of splits of the last detectCommunities run, every level of it can be cut
+     * without running the detection again
+     */
+    const Dendrogram &getDendrogram() const { return dendrogram; }
+    Graph getGraph() { return toBoostGraph(nullptr); } //return the original graph
+    const CSRGraph &getCSR() const { return csr; } //return the CSR form of the original graph
+    string node_name(int vertexIndex) { return names[vertexIndex]; }
+    /**
+     * @brief write the graph and its vertex names to a GraphSnapshot file, so a later run can load it
+     * without parsing the edge list again
+     * @param path file path
+     * @return true if the whole file was written
+     */
+    bool writeSnapshot(const string &path) const;
     /**
      * @brief convert map<key, value> to map<value, vector<key>>
      * @param subClusters map<key, value>
@@ -0,0 +1,147 @@
+/**
+ * @brief source file for GraphSnapshot class implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "GraphSnapshot.h"
+#include "BinaryIO.h"
+#include <cstring>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const char magic[4] = {'G', 'N', 'S', 'G'};
+    const uint32_t formatVersion = 1;
+    const size_t headerSize = sizeof(magic) + 3 * sizeof(uint32_t) + sizeof(uint64_t);
+
+    /**
+     * @brief check that offsets start at 0, never decrease and end at last
+     */
+    template<typename T>
+    bool validOffsets(const std::vector<T> &offsets, uint64_t last) {
+        if (offsets.front() != 0 || offsets.back() != last) {
+            return false;
+        }
+        for (size_t i = 1; i < offsets.size(); ++i) {
+            if (offsets[i] < offsets[i - 1]) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+bool GraphSnapshot::isSnapshot(const std::string &path) {
+    // a snapshot is mapped, so it is a regular file; reading a pipe here would lose its first bytes
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) {
+        return false;
+    }
+    std::ifstream in(path, std::ios::binary);
+    char header[sizeof(magic)];
+    return in.read(header, sizeof(header)) && std::memcmp(header, magic, sizeof(magic)) == 0;
+}
+
+bool GraphSnapshot::write(const std::string &path, const CSRGraph &graph, const std::vector<std::string> &names) {
+    uint32_t n = graph.numVertices();
+    uint32_t m = graph.numEdges();
+    if (names.size() != n) {
+        return false;
+    }
+    std::vector<uint64_t> nameOffsets(n + 1, 0);
+    for (uint32_t v = 0; v < n; ++v) {
+        nameOffsets[v + 1] = nameOffsets[v] + names[v].size();
+    }
+    std::vector<uint32_t> endpoints(2 * size_t(m)); // source and target of each edge id, flat
+    for (uint32_t e = 0; e < m; ++e) {
+        endpoints[2 * e] = graph.endpoints(e).first;
+        endpoints[2 * e + 1] = graph.endpoints(e).second;
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(magic, sizeof(magic));
+    writeBinary(out, formatVersion);
+    writeBinary(out, n);
+    writeBinary(out, m);
+    writeBinary(out, nameOffsets[n]);
+    writeBinary(out, graph.offsets().data(), graph.offsets().size());
+    writeBinary(out, graph.neighbors().data(), graph.neighbors().size());
+    writeBinary(out, graph.edgeIds().data(), graph.edgeIds().size());
+    writeBinary(out, endpoints.data(), endpoints.size());
+    writeBinary(out, nameOffsets.data(), nameOffsets.size());
+    for (const std::string &name : names) {
+        out.write(name.data(), name.size());
+    }
+    out.close();
+    return (bool) out;
+}
+
+bool GraphSnapshot::load(const std::string &path) {
+    *this = GraphSnapshot();
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t) info.st_size < headerSize) {
+        close(fd);
+        return false;
+    }
+    size_t size = info.st_size;
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    // 1. header, then the size the arrays must add up to
+    const char *at = static_cast<const char *>(data);
+    uint32_t version, n, m;
+    uint64_t nameBytes;
+    bool valid = std::memcmp(at, magic, sizeof(magic)) == 0;
+    at += sizeof(magic);
+    std::memcpy(&version, at, sizeof(version));
+    std::memcpy(&n, at + 4, sizeof(n));
+    std::memcpy(&m, at + 8, sizeof(m));
+    std::memcpy(&nameBytes, at + 12, sizeof(nameBytes));
+    at += headerSize - sizeof(magic);
+    uint64_t arrays = (uint64_t(n) + 1) * (sizeof(uint32_t) + sizeof(uint64_t)) + uint64_t(m) * 6 * sizeof(uint32_t);
+    valid = valid && version == formatVersion && n != UINT32_MAX && size - headerSize >= arrays
+            && size - headerSize - arrays == nameBytes;
+
+    // 2. copy the arrays and check every index, so a damaged file cannot be read out of range
+    std::vector<uint32_t> offsets, neighbors, edgeIds, words;
+    std::vector<uint64_t> nameOffsets;
+    if (valid) {
+        copyBinary(at, offsets, n + 1);
+        copyBinary(at, neighbors, 2 * size_t(m));
+        copyBinary(at, edgeIds, 2 * size_t(m));
+        copyBinary(at, words, 2 * size_t(m));
+        copyBinary(at, nameOffsets, n + 1);
+        valid = validOffsets(offsets, 2 * uint64_t(m)) && validOffsets(nameOffsets, nameBytes);
+        for (size_t i = 0; valid && i < neighbors.size(); ++i) {
+            valid = neighbors[i] < n && edgeIds[i] < m;
+        }
+        for (size_t i = 0; valid && i < words.size(); ++i) {
+            valid = words[i] < n;
+        }
+    }
+    if (valid) {
+        std::vector<std::pair<uint32_t, uint32_t>> endpoints(m);
+        for (uint32_t e = 0; e < m; ++e) {
+            endpoints[e] = {words[2 * e], words[2 * e + 1]};
+        }
+        this->names.reserve(n);
+        for (uint32_t v = 0; v < n; ++v) {
+            this->names.emplace_back(at + nameOffsets[v], nameOffsets[v + 1] - nameOffsets[v]);
+        }
+        this->csr = CSRGraph(std::move(offsets), std::move(neighbors), std::move(edgeIds), std::move(endpoints));
+    }
+    munmap(data, size);
+    return valid;
+}
@@ -0,0 +1,65 @@
+/**
+ * @brief header file for GraphSnapshot class declaration
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef GRAPHSNAPSHOT_H
+#define GRAPHSNAPSHOT_H
+
+#include "CSRGraph.h"
+#include <string>
+#include <vector>
+
+/**
+ * @brief The GraphSnapshot class stores a numbered graph in a versioned binary file, so the same graph
+ * can be loaded again without parsing the edge list or numbering the names.
+ *
+ * The file is the magic "GNSG", then the format version, n and m as 32-bit words and the size of the
+ * name bytes as a 64-bit word, then the arrays of the CSRGraph: n + 1 offsets, 2m neighbors, 2m edge
+ * ids and m (source, target) endpoints as 32-bit words, then the n + 1 offsets of the names into the
+ * name bytes as 64-bit words and the name bytes. Everything is little endian and unpadded.
+ *
+ * Loading is not zero-copy: the file is memory mapped, then every array is copied from the mapping into
+ * the vectors of a CSRGraph with memcpy and every name into a std::string, and the mapping is released.
+ * Nothing is parsed or sorted, so loading costs one pass over the file. The indices are checked for
+ * bounds while they are copied, so a damaged file is rejected rather than read out of range.
+ */
+class GraphSnapshot {
+private:
+    CSRGraph csr;
+    std::vector<std::string> names; // name of each vertex
+
+public:
+    /**
+     * @brief check whether a regular file starts with the snapshot magic; pipes are not read
+     * @param path file path
+     * @return true if the file can be opened and is a snapshot of any version
+     */
+    static bool isSnapshot(const std::string &path);
+    /**
+     * @brief write a graph and the names of its vertices to a snapshot file
+     * @param path file path, an existing file is replaced
+     * @param graph graph to store
+     * @param names name of each vertex of graph
+     * @return true if the whole file was written
+     */
+    static bool write(const std::string &path, const CSRGraph &graph, const std::vector<std::string> &names);
+    /**
+     * @brief load a snapshot file written by write
+     * @param path file path
+     * @return false if the file cannot be read, is of another version or is damaged
+     */
+    bool load(const std::string &path);
+
+    /**
+     * @brief the loaded graph; it may be moved out, e.g. into a GVGraph
+     */
+    CSRGraph &graph() { return csr; }
+    /**
+     * @brief the name of each vertex of the loaded graph; it may be moved out
+     */
+    std::vector<std::string> &vertexNames() { return names; }
+};
+
+#endif //GRAPHSNAPSHOT_H
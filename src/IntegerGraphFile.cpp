@@ -0,0 +1,326 @@
+/**
+ * @brief source file for IntegerGraphFile class implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "IntegerGraphFile.h"
+#include "ParallelFor.h"
+#include "TextFile.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+
+namespace {
+    /**
+     * @brief read the next unsigned number of a line, after spaces and tabs
+     * @param line rest of the line, the number is removed from it
+     * @param value receives the number
+     * @return false at the end of the line or if the next word is not a number
+     */
+    bool nextNumber(std::string_view &line, uint64_t &value) {
+        size_t first = line.find_first_not_of(" \t");
+        if (first == std::string_view::npos) {
+            return false;
+        }
+        auto [last, error] = std::from_chars(line.data() + first, line.data() + line.size(), value);
+        if (error != std::errc()) {
+            return false;
+        }
+        line.remove_prefix(last - line.data());
+        return true;
+    }
+
+    /**
+     * @brief check that only spaces (and the carriage return of CRLF files) are left in a line
+     */
+    bool isBlank(std::string_view line) {
+        return line.find_first_not_of(" \t\r") == std::string_view::npos;
+    }
+
+    /**
+     * @brief check whether a line is a '%' comment
+     */
+    bool isComment(std::string_view line) {
+        size_t first = line.find_first_not_of(" \t");
+        return first != std::string_view::npos && line[first] == '%';
+    }
+
+    /**
+     * @brief the next word of a line in lower case, after spaces and tabs
+     */
+    std::string nextWord(std::string_view &line) {
+        size_t first = std::min(line.find_first_not_of(" \t\r"), line.size());
+        size_t last = std::min(line.find_first_of(" \t\r", first), line.size());
+        std::string word(line.substr(first, last - first));
+        std::transform(word.begin(), word.end(), word.begin(), [](unsigned char c) { return std::tolower(c); });
+        line.remove_prefix(last);
+        return word;
+    }
+}
+
+bool IntegerGraphFile::formatByName(const std::string &name, Format &format) {
+    if (name == "snap") {
+        format = Format::SNAP;
+    } else if (name == "metis") {
+        format = Format::METIS;
+    } else if (name == "mm") {
+        format = Format::MatrixMarket;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void IntegerGraphFile::setNumThreads(unsigned int threads) {
+    this->numThreads = resolveThreads(threads);
+}
+
+bool IntegerGraphFile::load(const std::string &path) {
+    bool valid = false;
+    return readTextFile(path, [&](std::string_view text) { valid = parse(text); }) && valid;
+}
+
+bool IntegerGraphFile::load(std::istream &in) {
+    bool valid = false;
+    return readTextStream(in, [&](std::string_view text) { valid = parse(text); }) && valid;
+}
+
+bool IntegerGraphFile::parse(std::string_view text) {
+    this->ids.clear();
+    this->edges.clear();
+    bool valid = false;
+    switch (this->format) {
+        case Format::SNAP:
+            valid = parseSNAP(text);
+            break;
+        case Format::METIS:
+            valid = parseMETIS(text);
+            break;
+        case Format::MatrixMarket:
+            valid = parseMatrixMarket(text);
+            break;
+    }
+    if (!valid) {
+        this->ids.clear();
+        this->edges.clear();
+    }
+    return valid;
+}
+
+std::vector<std::string> IntegerGraphFile::vertexNames() const {
+    std::vector<std::string> names(this->ids.size());
+    for (size_t v = 0; v < this->ids.size(); ++v) {
+        names[v] = std::to_string(this->ids[v]);
+    }
+    return names;
+}
+
+std::vector<std::pair<uint64_t, uint64_t>> IntegerGraphFile::parsePairs(std::string_view text, size_t hint) const {
+    std::vector<std::string_view> chunks = splitLines(text, this->numThreads);
+    std::vector<std::vector<std::pair<uint64_t, uint64_t>>> parsed(chunks.size());
+    hint = std::min(hint, text.size() / 4 + 1); // a pair takes at least 4 bytes ("1 2\n")
+    parallelFor(chunks.size(), this->numThreads, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t c = begin; c < end; ++c) {
+            // share of the hint by chunk size, in double so the product cannot overflow on huge inputs
+            parsed[c].reserve((size_t) ((double) hint * chunks[c].size() / text.size()));
+            std::string_view rest = chunks[c];
+            while (!rest.empty()) {
+                // comments start with '#' or '%', so they are not numbers either
+                std::string_view line = nextLine(rest);
+                uint64_t u, v;
+                if (nextNumber(line, u) && nextNumber(line, v)) {
+                    parsed[c].emplace_back(u, v);
+                }
+            }
+        }
+    }, 1);
+    if (parsed.size() == 1) {
+        return std::move(parsed[0]);
+    }
+
+    std::vector<size_t> offset(parsed.size() + 1, 0);
+    for (size_t c = 0; c < parsed.size(); ++c) {
+        offset[c + 1] = offset[c] + parsed[c].size();
+    }
+    std::vector<std::pair<uint64_t, uint64_t>> pairs(offset.back());
+    parallelFor(parsed.size(), this->numThreads, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t c = begin; c < end; ++c) {
+            std::copy(parsed[c].begin(), parsed[c].end(), pairs.begin() + offset[c]);
+        }
+    }, 1);
+    return pairs;
+}
+
+bool IntegerGraphFile::parseSNAP(std::string_view text) {
+    std::vector<std::pair<uint64_t, uint64_t>> pairs = parsePairs(text, 0);
+    uint64_t maxId = 0;
+    for (auto const &[u, v] : pairs) {
+        maxId = std::max(maxId, std::max(u, v));
+    }
+
+    // number the ids that appear in increasing order: through a table indexed by id when the ids are
+    // dense enough, else by sorting them
+    std::vector<uint32_t> vertex; // vertex of each id, for the table
+    if (maxId < std::min<uint64_t>(UINT32_MAX, 8 * pairs.size() + 1024)) {
+        vertex.assign(maxId + 1, 0);
+        for (auto const &[u, v] : pairs) {
+            vertex[u] = 1;
+            vertex[v] = 1;
+        }
+        for (uint64_t id = 0; id <= maxId; ++id) {
+            if (vertex[id]) {
+                vertex[id] = this->ids.size();
+                this->ids.push_back(id);
+            }
+        }
+    } else {
+        this->ids.reserve(2 * pairs.size());
+        for (auto const &[u, v] : pairs) {
+            this->ids.push_back(u);
+            this->ids.push_back(v);
+        }
+        std::sort(this->ids.begin(), this->ids.end());
+        this->ids.erase(std::unique(this->ids.begin(), this->ids.end()), this->ids.end());
+        if (this->ids.size() >= UINT32_MAX) {
+            return false;
+        }
+    }
+
+    this->edges.resize(pairs.size());
+    parallelFor(pairs.size(), this->numThreads, [&](size_t begin, size_t end, unsigned int) {
+        auto number = [&](uint64_t id) -> uint32_t {
+            if (!vertex.empty()) {
+                return vertex[id];
+            }
+            return std::lower_bound(this->ids.begin(), this->ids.end(), id) - this->ids.begin();
+        };
+        for (size_t e = begin; e < end; ++e) {
+            this->edges[e] = {number(pairs[e].first), number(pairs[e].second)};
+        }
+    }, 1 << 16);
+    return true;
+}
+
+bool IntegerGraphFile::parseMETIS(std::string_view text) {
+    // header "n m [fmt [ncon]]" after the comments; the digits of fmt flag vertex sizes, vertex weights
+    // and edge weights
+    std::string_view header;
+    do {
+        if (text.empty()) {
+            return false;
+        }
+        header = nextLine(text);
+    } while (isComment(header) || isBlank(header));
+    uint64_t n, m, fmt = 0, ncon = 1;
+    if (!nextNumber(header, n) || !nextNumber(header, m) || n >= UINT32_MAX) {
+        return false;
+    }
+    if (nextNumber(header, fmt)) {
+        nextNumber(header, ncon);
+    }
+    if (fmt % 10 > 1 || fmt / 10 % 10 > 1 || fmt / 100 > 1 || !isBlank(header)) {
+        return false;
+    }
+    m = std::min<uint64_t>(m, text.size()); // only a hint for reserving
+    bool edgeWeights = fmt % 10 == 1;
+    size_t skip = fmt / 100 + (fmt / 10 % 10 == 1 ? ncon : 0); // numbers before the neighbors
+
+    // line k of the body is vertex k, so every chunk first counts its vertex lines
+    std::vector<std::string_view> chunks = splitLines(text, this->numThreads);
+    std::vector<size_t> first(chunks.size() + 1, 0); // first vertex of each chunk
+    parallelFor(chunks.size(), this->numThreads, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t c = begin; c < end; ++c) {
+            std::string_view rest = chunks[c];
+            while (!rest.empty()) {
+                first[c + 1] += !isComment(nextLine(rest));
+            }
+        }
+    }, 1);
+    for (size_t c = 0; c < chunks.size(); ++c) {
+        first[c + 1] += first[c];
+    }
+
+    // keep each edge from its smaller endpoint
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> parsed(chunks.size());
+    std::vector<char> valid(chunks.size(), 1);
+    parallelFor(chunks.size(), this->numThreads, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t c = begin; c < end; ++c) {
+            parsed[c].reserve((size_t) ((double) m * chunks[c].size() / text.size()) + 1);
+            std::string_view rest = chunks[c];
+            for (uint64_t u = first[c]; valid[c] && !rest.empty();) {
+                std::string_view line = nextLine(rest);
+                if (isComment(line)) {
+                    continue;
+                }
+                if (u >= n) {
+                    valid[c] = isBlank(line); // only blank lines may follow the last vertex
+                    continue;
+                }
+                uint64_t v, weight;
+                for (size_t i = 0; i < skip; ++i) {
+                    valid[c] = valid[c] && nextNumber(line, weight);
+                }
+                while (valid[c] && nextNumber(line, v)) {
+                    valid[c] = v >= 1 && v <= n && (!edgeWeights || nextNumber(line, weight));
+                    if (valid[c] && u <= v - 1) {
+                        parsed[c].emplace_back(u, v - 1);
+                    }
+                }
+                valid[c] = valid[c] && isBlank(line);
+                ++u;
+            }
+        }
+    }, 1);
+    if (std::find(valid.begin(), valid.end(), 0) != valid.end()) {
+        return false;
+    }
+
+    // vertices without a line at the end of the file have no neighbors
+    this->ids.resize(n);
+    for (uint32_t v = 0; v < n; ++v) {
+        this->ids[v] = v + 1;
+    }
+    for (auto const &chunkEdges : parsed) {
+        this->edges.insert(this->edges.end(), chunkEdges.begin(), chunkEdges.end());
+    }
+    return true;
+}
+
+bool IntegerGraphFile::parseMatrixMarket(std::string_view text) {
+    // banner "%%MatrixMarket matrix coordinate <field> <symmetry>", the words are case insensitive; the
+    // field and the symmetry do not matter since only the positions of the entries are read
+    std::string_view banner = nextLine(text);
+    if (nextWord(banner) != "%%matrixmarket" || nextWord(banner) != "matrix" || nextWord(banner) != "coordinate") {
+        return false;
+    }
+    std::string_view size;
+    do {
+        if (text.empty()) {
+            return false;
+        }
+        size = nextLine(text);
+    } while (isComment(size) || isBlank(size));
+    uint64_t rows, cols, entries;
+    if (!nextNumber(size, rows) || !nextNumber(size, cols) || !nextNumber(size, entries)
+        || std::max(rows, cols) >= UINT32_MAX) {
+        return false;
+    }
+
+    std::vector<std::pair<uint64_t, uint64_t>> pairs = parsePairs(text, entries);
+    for (auto const &[i, j] : pairs) {
+        if (i < 1 || i > rows || j < 1 || j > cols) {
+            return false;
+        }
+    }
+    uint64_t n = std::max(rows, cols);
+    this->ids.resize(n);
+    for (uint32_t v = 0; v < n; ++v) {
+        this->ids[v] = v + 1;
+    }
+    this->edges.resize(pairs.size());
+    for (size_t e = 0; e < pairs.size(); ++e) {
+        this->edges[e] = {(uint32_t) (pairs[e].first - 1), (uint32_t) (pairs[e].second - 1)};
+    }
+    return true;
+}
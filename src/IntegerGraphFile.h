@@ -0,0 +1,109 @@
+/**
+ * @brief header file for IntegerGraphFile class declaration
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef INTEGERGRAPHFILE_H
+#define INTEGERGRAPHFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief The IntegerGraphFile class loads the standard graph formats whose vertices are integers. The ids
+ * are used as they are, without interning names, and vertices are numbered in the order of their ids:
+ *  - SNAP: one "u v" edge per line, separated by spaces or tabs; lines starting with '#' or '%' are
+ *    comments and columns after the second are ignored. Only ids that appear become vertices.
+ *  - METIS: the header "n m [fmt [ncon]]", then one line per vertex 1..n with its 1-based neighbors,
+ *    preceded by its size and weights and each followed by an edge weight when fmt says so. Every edge
+ *    is listed by both endpoints and is kept once; the weights and the edge count m are not used.
+ *  - Matrix Market: the "%%MatrixMarket matrix coordinate" banner, the size line "rows cols entries",
+ *    then one 1-based "i j [value]" entry per line; every entry is an edge and the values are not used.
+ *    The vertices are 1..max(rows, cols).
+ * Directed inputs are read as undirected, so an edge listed in both directions in a SNAP file or a
+ * general matrix appears twice. The file is read like an EdgeListFile: memory mapped or streamed, and
+ * parsed in newline-aligned chunks on several threads; the result does not depend on the threads.
+ */
+class IntegerGraphFile {
+public:
+    /**
+     * @brief The Format enum lists the supported file formats
+     */
+    enum class Format {
+        SNAP,
+        METIS,
+        MatrixMarket
+    };
+
+private:
+    Format format;
+    unsigned int numThreads = 1;
+    std::vector<uint64_t> ids; // id of each vertex in the file, in increasing order
+    std::vector<std::pair<uint32_t, uint32_t>> edges; // (source, target) of each edge
+
+    /**
+     * @brief parse the "u v" lines of text into pairs of ids on several threads, in file order;
+     * blank lines, comments and lines that do not start with two numbers are skipped
+     * @param text lines to parse
+     * @param hint expected number of pairs, to reserve memory
+     * @return the pairs
+     */
+    std::vector<std::pair<uint64_t, uint64_t>> parsePairs(std::string_view text, size_t hint) const;
+    bool parseSNAP(std::string_view text);
+    bool parseMETIS(std::string_view text);
+    bool parseMatrixMarket(std::string_view text);
+
+public:
+    /**
+     * @brief constructor
+     * @param format format of the files to load
+     */
+    explicit IntegerGraphFile(Format format) : format(format) {}
+    /**
+     * @brief look up a format by its command line name: snap, metis or mm
+     * @param name format name
+     * @param format receives the format
+     * @return false if the name is unknown
+     */
+    static bool formatByName(const std::string &name, Format &format);
+    /**
+     * @brief set the number of parsing threads
+     * @param threads number of threads, 0 uses every hardware thread
+     */
+    void setNumThreads(unsigned int threads);
+    /**
+     * @brief load a file, replacing the content of the object
+     * @param path path of the file
+     * @return false if the file cannot be read or is not valid in the format
+     */
+    bool load(const std::string &path);
+    /**
+     * @brief read a stream up to its end and parse it, replacing the content of the object
+     * @param in stream, e.g. std::cin
+     * @return false if reading failed or the content is not valid in the format
+     */
+    bool load(std::istream &in);
+    /**
+     * @brief parse the content of a file held in memory
+     * @param text content of the file
+     * @return false if the content is not valid in the format, the object is then empty
+     */
+    bool parse(std::string_view text);
+
+    uint32_t numVertices() const { return ids.size(); }
+    const std::vector<uint64_t> &vertexIds() const { return ids; }
+    const std::vector<std::pair<uint32_t, uint32_t>> &edgeList() const { return edges; }
+    /**
+     * @brief the ids as names, for output
+     * @return the decimal id of each vertex
+     */
+    std::vector<std::string> vertexNames() const;
+};
+
+#endif //INTEGERGRAPHFILE_H
@@ -0,0 +1,101 @@
+/**
+ * @brief source file for LabelPropagation class implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "LabelPropagation.h"
+#include "ModularityTracker.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+namespace {
+    /**
+     * @brief splitmix64 finalizer, hashes the tie break keys
+     */
+    uint64_t mix(uint64_t x) {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+}
+
+void LabelPropagation::setNumThreads(unsigned int threads) {
+    this->numThreads = resolveThreads(threads);
+}
+
+Partition LabelPropagation::run() {
+    uint32_t n = this->graph->numVertices();
+    const std::vector<uint32_t> &offsets = this->graph->offsets();
+    const std::vector<uint32_t> &neighbors = this->graph->neighbors();
+    std::vector<std::atomic<uint32_t>> label(n);
+    for (uint32_t v = 0; v < n; ++v) {
+        label[v].store(v, std::memory_order_relaxed);
+    }
+    std::vector<Scratch> scratch(this->numThreads);
+    for (Scratch &s : scratch) {
+        s.count.assign(n, 0);
+    }
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937_64 generator(this->seed);
+
+    this->rounds = 0;
+    for (bool changed = true; changed && this->rounds < this->maxRounds; ++this->rounds) {
+        std::shuffle(order.begin(), order.end(), generator);
+        std::atomic<bool> anyChange(false);
+        parallelFor(n, this->numThreads, [&](size_t begin, size_t end, unsigned int worker) {
+            Scratch &s = scratch[worker];
+            bool localChange = false;
+            for (size_t k = begin; k < end; ++k) {
+                uint32_t v = order[k];
+                s.touched.clear();
+                for (uint32_t j = offsets[v]; j < offsets[v + 1]; ++j) {
+                    uint32_t l = label[neighbors[j]].load(std::memory_order_relaxed);
+                    if (s.count[l]++ == 0) {
+                        s.touched.push_back(l);
+                    }
+                }
+                if (s.touched.empty()) {
+                    continue;
+                }
+                uint32_t current = label[v].load(std::memory_order_relaxed);
+                uint32_t best = current;
+                uint32_t bestCount = s.count[current];
+                uint64_t bestHash = 0;
+                for (uint32_t l : s.touched) {
+                    if (s.count[l] < bestCount || l == current) {
+                        continue;
+                    }
+                    uint64_t hash = mix(this->seed ^ mix(((uint64_t) v << 32) | l));
+                    if (s.count[l] > bestCount || (best != current && hash < bestHash)) {
+                        best = l;
+                        bestCount = s.count[l];
+                        bestHash = hash;
+                    }
+                }
+                for (uint32_t l : s.touched) {
+                    s.count[l] = 0;
+                }
+                if (best != current) {
+                    label[v].store(best, std::memory_order_relaxed);
+                    localChange = true;
+                }
+            }
+            if (localChange) {
+                anyChange.store(true, std::memory_order_relaxed);
+            }
+        });
+        changed = anyChange.load();
+    }
+
+    std::vector<int> labels(n);
+    for (uint32_t v = 0; v < n; ++v) {
+        labels[v] = label[v].load(std::memory_order_relaxed);
+    }
+    ModularityTracker modularity(*this->graph, labels);
+    return Partition(labels, modularity.modularity());
+}
@@ -0,0 +1,72 @@
+/**
+ * @brief header file for LabelPropagation class declaration
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef LABELPROPAGATION_H
+#define LABELPROPAGATION_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "CSRGraph.h"
+#include "Partition.h"
+
+/**
+ * @brief The LabelPropagation class detects communities by asynchronous label propagation
+ * (Raghavan et al. 2007). Every vertex starts with its own label; in each round the vertices, in an
+ * order shuffled from the seed, take the label most of their neighbors have, until no label changes.
+ * A round costs O(m), so it is the low latency engine.
+ *
+ * Labels are updated in place, so a vertex already sees the labels its neighbors took earlier in the
+ * same round. Ties go to the current label, then to the label with the lowest hash of (seed, vertex,
+ * label). With one thread the result only depends on the seed; with more threads the interleaving of
+ * the updates can change it.
+ */
+class LabelPropagation {
+private:
+    /**
+     * @brief The Scratch struct holds the per-thread label counts of one vertex
+     */
+    struct Scratch {
+        std::vector<uint32_t> count; // number of neighbors with each label
+        std::vector<uint32_t> touched; // labels with a non-zero count
+    };
+
+    const CSRGraph *graph;
+    unsigned int numThreads = 1;
+    uint64_t seed = 5489;
+    size_t maxRounds = 100;
+    size_t rounds = 0; // number of rounds of the last run
+
+public:
+    /**
+     * @brief constructor
+     * @param iGraph graph to partition, must outlive the object
+     */
+    explicit LabelPropagation(const CSRGraph &iGraph) : graph(&iGraph) {}
+
+    /**
+     * @brief propagate labels until a round changes none or maxRounds rounds ran
+     * @return the communities and their modularity in the graph
+     */
+    Partition run();
+    size_t numRounds() const { return rounds; }
+    /**
+     * @brief set the number of threads
+     * @param threads number of threads, 0 uses every hardware thread
+     */
+    void setNumThreads(unsigned int threads);
+    /**
+     * @brief set the seed of the visiting order and of the tie breaks
+     */
+    void setSeed(uint64_t value) { seed = value; }
+    /**
+     * @brief set the largest number of rounds, label propagation can oscillate on some graphs
+     */
+    void setMaxRounds(size_t value) { maxRounds = value; }
+};
+
+#endif //LABELPROPAGATION_H
@@ -0,0 +1,335 @@
+/**
+ * @brief source file for Leiden class implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "Leiden.h"
+#include "ModularityTracker.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+
+namespace {
+    const double tolerance = 1e-12; // smallest gain that counts as an improvement
+}
+
+void Leiden::setNumThreads(unsigned int threads) {
+    this->numThreads = resolveThreads(threads);
+}
+
+void Leiden::gatherWeights(const WeightedGraph &level, const std::vector<uint32_t> &community, uint32_t i,
+                           Scratch &s) const {
+    s.touched.clear();
+    for (uint32_t j = level.offsets[i]; j < level.offsets[i + 1]; ++j) {
+        uint32_t c = community[level.neighbors[j]];
+        if (s.neighborWeight[c] == 0) {
+            s.touched.push_back(c);
+        }
+        s.neighborWeight[c] += level.weights[j];
+    }
+}
+
+void Leiden::colourNodes(const WeightedGraph &level, std::vector<uint32_t> &start,
+                         std::vector<uint32_t> &nodes) {
+    uint32_t n = level.numNodes();
+    std::vector<std::pair<uint64_t, uint32_t>> priority(n); // hashed priority of each node, ties by node
+    parallelFor(n, this->numThreads, [&](size_t begin, size_t end, unsigned int) {
+        for (uint32_t i = begin; i < end; ++i) {
+            uint64_t x = (i + 1) * 0x9E3779B97F4A7C15ULL; // splitmix64 finalizer
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+            priority[i] = {x ^ (x >> 31), i};
+        }
+    });
+    std::vector<uint32_t> colour(n, UINT32_MAX);
+    std::vector<uint32_t> pending(n);
+    std::iota(pending.begin(), pending.end(), 0);
+    std::vector<char> selected(n, 0);
+    uint32_t numColours = 0;
+    while (!pending.empty()) {
+        // 1. pick the nodes that beat their uncoloured neighbors; no two of them are neighbors
+        parallelFor(pending.size(), this->numThreads, [&](size_t begin, size_t end, unsigned int) {
+            for (size_t k = begin; k < end; ++k) {
+                uint32_t i = pending[k];
+                bool top = true;
+                for (uint32_t j = level.offsets[i]; top && j < level.offsets[i + 1]; ++j) {
+                    uint32_t w = level.neighbors[j];
+                    top = colour[w] != UINT32_MAX || priority[w] < priority[i];
+                }
+                selected[i] = top;
+            }
+        });
+        // 2. give each of them the smallest colour its neighbors do not have
+        parallelFor(pending.size(), this->numThreads, [&](size_t begin, size_t end, unsigned int worker) {
+            std::vector<char> &used = this->scratch[worker].used;
+            for (size_t k = begin; k < end; ++k) {
+                uint32_t i = pending[k];
+                if (!selected[i]) {
+                    continue;
+                }
+                uint32_t degree = level.offsets[i + 1] - level.offsets[i];
+                used.assign(degree + 1, 0);
+                for (uint32_t j = level.offsets[i]; j < level.offsets[i + 1]; ++j) {
+                    uint32_t c = colour[level.neighbors[j]];
+                    if (c <= degree) {
+                        used[c] = 1;
+                    }
+                }
+                colour[i] = std::find(used.begin(), used.end(), 0) - used.begin();
+            }
+        });
+        size_t left = 0;
+        for (uint32_t i : pending) {
+            if (selected[i]) {
+                numColours = std::max(numColours, colour[i] + 1);
+            } else {
+                pending[left++] = i;
+            }
+        }
+        pending.resize(left);
+    }
+    groupMembers(colour, numColours, start, nodes);
+}
+
+void Leiden::moveNodes(const WeightedGraph &level, std::vector<uint32_t> &community,
+                       const std::vector<double> &degree, double m2) {
+    uint32_t n = level.numNodes();
+    std::vector<uint32_t> colourStart, byColour;
+    colourNodes(level, colourStart, byColour);
+    std::vector<double> total(n, 0);
+    for (uint32_t i = 0; i < n; ++i) {
+        total[community[i]] += degree[i];
+    }
+    std::vector<uint32_t> proposal(n);
+    std::vector<double> toCurrent(n); // weight from each node to its community, without itself
+    std::vector<double> toTarget(n); // weight from each node to its proposed community
+    // a node is visited again only when a neighbor moved since its last visit
+    std::vector<std::atomic<char>> active(n);
+    for (std::atomic<char> &flag : active) {
+        flag.store(1, std::memory_order_relaxed);
+    }
+    std::vector<uint32_t> movers;
+    for (bool moved = true; moved;) {
+        moved = false;
+        for (size_t colour = 0; colour + 1 < colourStart.size(); ++colour) {
+            uint32_t first = colourStart[colour];
+            // find the best move of every node of the colour; the gain of joining c is
+            // k_i,c - tot_c * k_i / m2, with i taken out of its community
+            parallelFor(colourStart[colour + 1] - first, this->numThreads,
+                        [&](size_t begin, size_t end, unsigned int worker) {
+                Scratch &s = this->scratch[worker];
+                for (size_t k = first + begin; k < first + end; ++k) {
+                    uint32_t i = byColour[k];
+                    proposal[i] = community[i];
+                    if (!active[i].exchange(0, std::memory_order_relaxed)) {
+                        continue;
+                    }
+                    gatherWeights(level, community, i, s);
+                    uint32_t current = community[i];
+                    uint32_t best = current;
+                    double bestGain = s.neighborWeight[current] - (total[current] - degree[i]) * degree[i] / m2;
+                    for (uint32_t c : s.touched) {
+                        double gain = s.neighborWeight[c] - total[c] * degree[i] / m2;
+                        if (c != current && gain > bestGain + tolerance) {
+                            best = c;
+                            bestGain = gain;
+                        }
+                    }
+                    proposal[i] = best;
+                    toCurrent[i] = s.neighborWeight[current];
+                    toTarget[i] = s.neighborWeight[best];
+                    for (uint32_t c : s.touched) {
+                        s.neighborWeight[c] = 0;
+                    }
+                }
+            });
+
+            // apply the moves in node order, each only if it still raises modularity, so every move
+            // raises modularity and the rounds end; no neighbor of a node moved since its weights were
+            // gathered, so only the totals need a second look
+            movers.clear();
+            for (uint32_t k = first; k < colourStart[colour + 1]; ++k) {
+                uint32_t i = byColour[k];
+                uint32_t current = community[i];
+                uint32_t target = proposal[i];
+                if (target == current) {
+                    continue;
+                }
+                double stay = toCurrent[i] - (total[current] - degree[i]) * degree[i] / m2;
+                double move = toTarget[i] - total[target] * degree[i] / m2;
+                if (move > stay + tolerance) {
+                    total[current] -= degree[i];
+                    total[target] += degree[i];
+                    community[i] = target;
+                    movers.push_back(i);
+                }
+            }
+            moved = moved || !movers.empty();
+            parallelFor(movers.size(), this->numThreads, [&](size_t begin, size_t end, unsigned int) {
+                for (size_t k = begin; k < end; ++k) {
+                    uint32_t i = movers[k];
+                    for (uint32_t j = level.offsets[i]; j < level.offsets[i + 1]; ++j) {
+                        active[level.neighbors[j]].store(1, std::memory_order_relaxed);
+                    }
+                }
+            }, 256);
+        }
+    }
+}
+
+std::vector<uint32_t> Leiden::refine(const WeightedGraph &level, const std::vector<uint32_t> &community,
+                                     const std::vector<double> &degree, double m2) {
+    uint32_t n = level.numNodes();
+    std::vector<uint32_t> start, members;
+    groupMembers(community, n, start, members);
+
+    // refined communities start as single nodes and are identified by their first node;
+    // outside[r] is the weight from r to the rest of its community
+    std::vector<uint32_t> refined(n);
+    std::iota(refined.begin(), refined.end(), 0);
+    std::vector<double> total(degree);
+    std::vector<uint32_t> size(n, 1);
+    std::vector<double> outside(n, 0);
+    parallelFor(n, this->numThreads, [&](size_t begin, size_t end, unsigned int) {
+        for (uint32_t i = begin; i < end; ++i) {
+            for (uint32_t j = level.offsets[i]; j < level.offsets[i + 1]; ++j) {
+                outside[i] += community[level.neighbors[j]] == community[i] ? level.weights[j] : 0;
+            }
+        }
+    });
+
+    // communities are refined independently, each by one thread; the threads take the communities that
+    // have nodes one at a time, the largest first, so a large community does not hold up the end
+    std::vector<uint32_t> order;
+    for (uint32_t c = 0; c < n; ++c) {
+        if (start[c + 1] > start[c]) {
+            order.push_back(c);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return start[a + 1] - start[a] > start[b + 1] - start[b];
+    });
+    parallelFor(order.size(), this->numThreads, [&](size_t begin, size_t end, unsigned int worker) {
+        Scratch &s = this->scratch[worker];
+        for (size_t x = begin; x < end; ++x) {
+            uint32_t c = order[x];
+            double K = 0;
+            for (uint32_t k = start[c]; k < start[c + 1]; ++k) {
+                K += degree[members[k]];
+            }
+            for (uint32_t k = start[c]; k < start[c + 1]; ++k) {
+                uint32_t v = members[k];
+                // only nodes still alone and well connected to their community move
+                if (size[refined[v]] > 1 || outside[v] < degree[v] * (K - degree[v]) / m2) {
+                    continue;
+                }
+                s.touched.clear();
+                for (uint32_t j = level.offsets[v]; j < level.offsets[v + 1]; ++j) {
+                    uint32_t w = level.neighbors[j];
+                    if (community[w] != c) {
+                        continue;
+                    }
+                    uint32_t r = refined[w];
+                    if (s.neighborWeight[r] == 0) {
+                        s.touched.push_back(r);
+                    }
+                    s.neighborWeight[r] += level.weights[j];
+                }
+                uint32_t best = v;
+                double bestGain = 0;
+                for (uint32_t r : s.touched) {
+                    bool wellConnected = outside[r] >= total[r] * (K - total[r]) / m2;
+                    double gain = s.neighborWeight[r] - total[r] * degree[v] / m2;
+                    if (r != v && wellConnected && gain > bestGain + tolerance) {
+                        best = r;
+                        bestGain = gain;
+                    }
+                }
+                if (best != v) {
+                    outside[best] += outside[v] - 2 * s.neighborWeight[best];
+                    total[best] += degree[v];
+                    ++size[best];
+                    refined[v] = best;
+                }
+                for (uint32_t r : s.touched) {
+                    s.neighborWeight[r] = 0;
+                }
+            }
+        }
+    }, 1);
+    return refined;
+}
+
+Partition Leiden::run() {
+    uint32_t n = this->graph->numVertices();
+    WeightedGraph level(*this->graph);
+    std::vector<uint32_t> community(n);
+    std::iota(community.begin(), community.end(), 0);
+    // node of the current level that holds each vertex
+    std::vector<uint32_t> membership(n);
+    std::iota(membership.begin(), membership.end(), 0);
+    this->scratch.resize(this->numThreads);
+    for (Scratch &s : this->scratch) {
+        s.neighborWeight.assign(n, 0);
+    }
+
+    this->levels = 0;
+    while (true) {
+        uint32_t nodes = level.numNodes();
+        std::vector<double> degree(nodes);
+        parallelFor(nodes, this->numThreads, [&](size_t begin, size_t end, unsigned int) {
+            for (uint32_t i = begin; i < end; ++i) {
+                degree[i] = level.degree(i);
+            }
+        });
+        double m2 = std::accumulate(degree.begin(), degree.end(), 0.0);
+        if (m2 == 0) {
+            break;
+        }
+
+        // 1. local moving
+        moveNodes(level, community, degree, m2);
+        std::vector<char> used(nodes, 0);
+        uint32_t count = 0;
+        for (uint32_t c : community) {
+            count += !used[c];
+            used[c] = 1;
+        }
+        if (count == nodes) {
+            break;
+        }
+
+        // 2. refinement, 3. aggregation of the refined communities
+        std::vector<uint32_t> refined = refine(level, community, degree, m2);
+        WeightedGraph next = level.aggregate(refined, this->numThreads);
+        if (next.numNodes() == nodes) {
+            break;
+        }
+        // the next level starts from the communities of step 1, renumbered below its node count
+        std::vector<uint32_t> renumber(nodes, UINT32_MAX);
+        std::vector<uint32_t> nextCommunity(next.numNodes());
+        uint32_t ids = 0;
+        for (uint32_t i = 0; i < nodes; ++i) {
+            uint32_t &id = renumber[community[i]];
+            if (id == UINT32_MAX) {
+                id = ids++;
+            }
+            nextCommunity[refined[i]] = id;
+        }
+        for (uint32_t &node : membership) {
+            node = refined[node];
+        }
+        level = std::move(next);
+        community = std::move(nextCommunity);
+        ++this->levels;
+    }
+
+    std::vector<int> labels(n);
+    for (uint32_t v = 0; v < n; ++v) {
+        labels[v] = community[membership[v]];
+    }
+    ModularityTracker modularity(*this->graph, labels);
+    return Partition(labels, modularity.modularity());
+}
@@ -0,0 +1,105 @@
+/**
+ * @brief header file for Leiden class declaration
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef LEIDEN_H
+#define LEIDEN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "CSRGraph.h"
+#include "Partition.h"
+#include "WeightedGraph.h"
+
+/**
+ * @brief The Leiden class detects communities with the Leiden algorithm (Traag et al. 2019). Every level
+ * 1. moves nodes between communities while modularity improves,
+ * 2. refines each community: its nodes start alone and only merge with well-connected refined
+ *    communities they have an edge to, so every refined community is connected,
+ * 3. collapses the refined communities into the nodes of the next level, which starts from the
+ *    communities of step 1.
+ *
+ * The work is spread over threads. Step 1 colours the nodes so that no two neighbors share a colour,
+ * then visits one colour at a time: the threads find the best move of every node of the colour, and
+ * since none of them are neighbors the weights from a node to the communities stay exact while the
+ * others move. The moves are then applied in node order, each in O(1) and only if it still raises
+ * modularity with the community sizes left by the moves before it. A node is only visited again
+ * after one of its neighbors moved. Step 2 refines the communities on
+ * the threads, the largest first, and step 3 builds the rows of the next level on the threads. The
+ * colouring and the merges do not depend on the threads, so neither does the result.
+ */
+class Leiden {
+private:
+    /**
+     * @brief The Scratch struct holds the per-thread arrays of one move or refinement
+     */
+    struct Scratch {
+        std::vector<double> neighborWeight; // weight from the current node to each community
+        std::vector<uint32_t> touched; // communities with a non-zero neighborWeight
+        std::vector<char> used; // colours of the neighbors of the node being coloured
+    };
+
+    const CSRGraph *graph;
+    unsigned int numThreads = 1;
+    size_t levels = 0; // number of levels of the last run
+    std::vector<Scratch> scratch; // one per thread
+
+    /**
+     * @brief colour the nodes so that no two neighbors share a colour, with Jones-Plassmann: in every
+     * round the uncoloured nodes whose hashed priority beats all their uncoloured neighbors take the
+     * smallest colour none of their neighbors has. The colouring is the same for any number of threads.
+     * @param level graph of the level
+     * @param start receives the offsets of the colours in nodes
+     * @param nodes receives the nodes by colour, in node order within a colour
+     */
+    void colourNodes(const WeightedGraph &level, std::vector<uint32_t> &start, std::vector<uint32_t> &nodes);
+    /**
+     * @brief sum the weights from node i to each neighboring community into s
+     */
+    void gatherWeights(const WeightedGraph &level, const std::vector<uint32_t> &community, uint32_t i,
+                       Scratch &s) const;
+    /**
+     * @brief step 1: move nodes between communities while a move raises modularity
+     * @param level graph of the level
+     * @param community community of each node, updated in place; ids are less than the number of nodes
+     * @param degree weighted degree of each node
+     * @param m2 sum of the degrees
+     */
+    void moveNodes(const WeightedGraph &level, std::vector<uint32_t> &community,
+                   const std::vector<double> &degree, double m2);
+    /**
+     * @brief step 2: split every community into connected refined communities
+     * @param level graph of the level
+     * @param community community of each node
+     * @param degree weighted degree of each node
+     * @param m2 sum of the degrees
+     * @return refined community of each node, identified by one of its nodes
+     */
+    std::vector<uint32_t> refine(const WeightedGraph &level, const std::vector<uint32_t> &community,
+                                 const std::vector<double> &degree, double m2);
+
+public:
+    /**
+     * @brief constructor
+     * @param iGraph graph to partition, must outlive the object
+     */
+    explicit Leiden(const CSRGraph &iGraph) : graph(&iGraph) {}
+
+    /**
+     * @brief run levels until every node of a level stays in its own community
+     * @return the communities and their modularity in the graph
+     */
+    Partition run();
+    size_t numLevels() const { return levels; }
+    /**
+     * @brief set the number of threads
+     * @param threads number of threads, 0 uses every hardware thread
+     */
+    void setNumThreads(unsigned int threads);
+    unsigned int getNumThreads() const { return numThreads; }
+};
+
+#endif //LEIDEN_H
@@ -0,0 +1,87 @@
+/**
+ * @brief source file for Louvain class implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "Louvain.h"
+#include "ModularityTracker.h"
+#include <numeric>
+
+bool Louvain::moveNodes(const WeightedGraph &level, std::vector<uint32_t> &community) {
+    uint32_t n = level.numNodes();
+    community.resize(n);
+    std::iota(community.begin(), community.end(), 0);
+    // k_i is the weighted degree of node i, tot_c the sum of k over community c, m2 the sum of all k
+    std::vector<double> degree(n);
+    double m2 = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        degree[i] = level.degree(i);
+        m2 += degree[i];
+    }
+    if (m2 == 0) {
+        return false;
+    }
+    std::vector<double> total(degree);
+    this->neighborWeight.assign(n, 0);
+
+    bool moved = false;
+    for (bool pass = true; pass;) {
+        pass = false;
+        for (uint32_t i = 0; i < n; ++i) {
+            uint32_t current = community[i];
+            this->touched.clear();
+            for (uint32_t j = level.offsets[i]; j < level.offsets[i + 1]; ++j) {
+                uint32_t c = community[level.neighbors[j]];
+                if (this->neighborWeight[c] == 0) {
+                    this->touched.push_back(c);
+                }
+                this->neighborWeight[c] += level.weights[j];
+            }
+
+            // gain of joining c, up to a constant factor: k_i,c - tot_c * k_i / m2
+            total[current] -= degree[i];
+            uint32_t best = current;
+            double bestGain = this->neighborWeight[current] - total[current] * degree[i] / m2;
+            for (uint32_t c : this->touched) {
+                double gain = this->neighborWeight[c] - total[c] * degree[i] / m2;
+                if (gain > bestGain + 1e-12) {
+                    best = c;
+                    bestGain = gain;
+                }
+            }
+            total[best] += degree[i];
+            community[i] = best;
+            if (best != current) {
+                pass = true;
+                moved = true;
+            }
+            for (uint32_t c : this->touched) {
+                this->neighborWeight[c] = 0;
+            }
+        }
+    }
+    return moved;
+}
+
+Partition Louvain::run() {
+    uint32_t n = this->graph->numVertices();
+    WeightedGraph level(*this->graph);
+
+    // node of the current level that holds each vertex
+    std::vector<uint32_t> membership(n);
+    std::iota(membership.begin(), membership.end(), 0);
+    std::vector<uint32_t> community;
+    this->levels = 0;
+    while (moveNodes(level, community)) {
+        ++this->levels;
+        level = level.aggregate(community);
+        for (uint32_t &node : membership) {
+            node = community[node];
+        }
+    }
+
+    std::vector<int> labels(membership.begin(), membership.end());
+    ModularityTracker modularity(*this->graph, labels);
+    return Partition(labels, modularity.modularity());
+}
@@ -0,0 +1,54 @@
+/**
+ * @brief header file for Louvain class declaration
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef LOUVAIN_H
+#define LOUVAIN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "CSRGraph.h"
+#include "Partition.h"
+#include "WeightedGraph.h"
+
+/**
+ * @brief The Louvain class detects communities by greedy modularity optimization (Blondel et al. 2008).
+ * Every level moves each node to the neighboring community with the largest modularity gain until no
+ * move helps, then collapses the communities into the nodes of a weighted graph for the next level.
+ * Each level costs O(m), so it runs on graphs Girvan-Newman cannot handle. Nodes are visited in index
+ * order, so the result is deterministic.
+ */
+class Louvain {
+private:
+    const CSRGraph *graph;
+    size_t levels = 0; // number of levels of the last run
+    std::vector<double> neighborWeight; // weight from the current node to each community, scratch
+    std::vector<uint32_t> touched; // communities with a non-zero neighborWeight, scratch
+
+    /**
+     * @brief move nodes between communities while a move raises modularity
+     * @param level graph of the level
+     * @param community receives the community of each node, starts as one community per node
+     * @return true if any node moved
+     */
+    bool moveNodes(const WeightedGraph &level, std::vector<uint32_t> &community);
+
+public:
+    /**
+     * @brief constructor
+     * @param iGraph graph to partition, must outlive the object
+     */
+    explicit Louvain(const CSRGraph &iGraph) : graph(&iGraph) {}
+
+    /**
+     * @brief run levels until no node moves
+     * @return the communities of the last level and their modularity in the graph
+     */
+    Partition run();
+    size_t numLevels() const { return levels; }
+};
+
+#endif //LOUVAIN_H
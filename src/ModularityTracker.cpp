@@ -0,0 +1,70 @@
+/**
+ * @brief source file for ModularityTracker class implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "ModularityTracker.h"
+#include <algorithm>
+
+ModularityTracker::ModularityTracker(const CSRGraph &iGraph, const std::vector<int> &labels)
+        : graph(&iGraph), label(labels) {
+    int numLabels = labels.empty() ? 0 : *std::max_element(labels.begin(), labels.end()) + 1;
+    this->internalEdges.assign(numLabels, 0);
+    this->degreeSum.assign(numLabels, 0);
+    for (uint32_t e = 0; e < iGraph.numEdges(); ++e) {
+        auto const &[u, v] = iGraph.endpoints(e);
+        if (labels[u] == labels[v]) {
+            ++this->internalEdges[labels[u]];
+        }
+        ++this->degreeSum[labels[u]];
+        ++this->degreeSum[labels[v]];
+    }
+    for (int c = 0; c < numLabels; ++c) {
+        this->q += term(c);
+    }
+}
+
+double ModularityTracker::term(int community) const {
+    uint32_t m = this->graph->numEdges();
+    if (m == 0) {
+        return 0;
+    }
+    double share = this->degreeSum[community] / (2.0 * m);
+    return this->internalEdges[community] / (double) m - share * share;
+}
+
+int ModularityTracker::split(const uint32_t *piece, size_t size) {
+    int old = this->label[piece[0]];
+    int created = this->internalEdges.size();
+    for (size_t i = 0; i < size; ++i) {
+        this->label[piece[i]] = created;
+    }
+
+    // edge ends of the piece: inside the piece (seen from both ends) or towards the rest of old
+    uint64_t insideEnds = 0;
+    uint64_t cut = 0;
+    uint64_t degree = 0;
+    const std::vector<uint32_t> &neighbors = this->graph->neighbors();
+    const std::vector<uint32_t> &offsets = this->graph->offsets();
+    for (size_t i = 0; i < size; ++i) {
+        uint32_t v = piece[i];
+        degree += offsets[v + 1] - offsets[v];
+        for (uint32_t j = offsets[v]; j < offsets[v + 1]; ++j) {
+            int other = this->label[neighbors[j]];
+            if (other == created) {
+                ++insideEnds;
+            } else if (other == old) {
+                ++cut;
+            }
+        }
+    }
+
+    this->q -= term(old);
+    this->internalEdges.push_back(insideEnds / 2);
+    this->degreeSum.push_back(degree);
+    this->internalEdges[old] -= insideEnds / 2 + cut;
+    this->degreeSum[old] -= degree;
+    this->q += term(old) + term(created);
+    return created;
+}
@@ -0,0 +1,56 @@
+/**
+ * @brief header file for ModularityTracker class declaration
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef MODULARITYTRACKER_H
+#define MODULARITYTRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "CSRGraph.h"
+
+/**
+ * @brief The ModularityTracker class keeps the modularity of a partition of a graph up to date while
+ * communities are split. For every community c it stores L_c (edges of the graph inside c) and d_c
+ * (sum of the degrees of c), so Q = sum over c of L_c / m - (d_c / 2m)^2 only changes by the terms of
+ * the community that splits. Degrees and edges are those of the whole graph, dead edges included.
+ */
+class ModularityTracker {
+private:
+    const CSRGraph *graph;
+    std::vector<int> label; // community of each vertex
+    std::vector<uint64_t> internalEdges; // L_c
+    std::vector<uint64_t> degreeSum; // d_c
+    double q = 0; // current modularity
+
+    /**
+     * @brief contribution of one community to Q
+     */
+    double term(int community) const;
+
+public:
+    /**
+     * @brief constructor
+     * @param iGraph graph the partition is evaluated on, must outlive the tracker
+     * @param labels initial community of each vertex, labels are 0..number of communities - 1
+     */
+    ModularityTracker(const CSRGraph &iGraph, const std::vector<int> &labels);
+
+    /**
+     * @brief move the vertices of a piece of one community into a new community. Costs the sum of the
+     * degrees of the piece, so callers should pass the smaller side of a split.
+     * @param piece vertices that leave their community, all in the same community
+     * @param size number of vertices in piece
+     * @return label of the new community
+     */
+    int split(const uint32_t *piece, size_t size);
+
+    double modularity() const { return q; }
+    int numCommunities() const { return internalEdges.size(); }
+    const std::vector<int> &labels() const { return label; }
+};
+
+#endif //MODULARITYTRACKER_H
@@ -0,0 +1,38 @@
+/**
+ * @brief source file for the parallelFor and resolveThreads functions implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "ParallelFor.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+void parallelFor(size_t count, unsigned int threads, const std::function<void(size_t, size_t, unsigned int)> &fn,
+                 size_t chunkSize) {
+    threads = std::min<size_t>(threads, std::max<size_t>((count + chunkSize - 1) / chunkSize, 1));
+    if (threads <= 1) {
+        fn(0, count, 0);
+        return;
+    }
+    std::atomic<size_t> next(0);
+    auto work = [&](unsigned int worker) {
+        for (size_t begin; (begin = next.fetch_add(chunkSize)) < count;) {
+            fn(begin, std::min(begin + chunkSize, count), worker);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned int t = 1; t < threads; ++t) {
+        workers.emplace_back(work, t);
+    }
+    work(0);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+unsigned int resolveThreads(unsigned int threads) {
+    return threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+}
@@ -0,0 +1,31 @@
+/**
+ * @brief header file for the parallelFor and resolveThreads functions declaration
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * @brief run fn over [0, count) in chunks that the threads pull in order
+ * @param count number of items
+ * @param threads number of threads, the calling thread is one of them
+ * @param fn called with (begin, end, thread) for every chunk; thread is 0..threads-1
+ * @param chunkSize items a thread takes at a time
+ */
+void parallelFor(size_t count, unsigned int threads, const std::function<void(size_t, size_t, unsigned int)> &fn,
+                 size_t chunkSize = 1024);
+
+/**
+ * @brief the number of threads a setNumThreads call asks for: 0 means one per hardware thread, and the
+ * result is at least 1
+ * @param threads requested number of threads
+ * @return number of threads to run on
+ */
+unsigned int resolveThreads(unsigned int threads);
+
+#endif //PARALLELFOR_H
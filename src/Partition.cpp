@@ -0,0 +1,28 @@
+/**
+ * @brief source file for Partition class implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "Partition.h"
+#include <algorithm>
+
+Partition::Partition(const std::vector<int> &labels, float modularity) : label(labels.size()), q(modularity) {
+    int numLabels = labels.empty() ? 0 : *std::max_element(labels.begin(), labels.end()) + 1;
+    std::vector<int> renumber(numLabels, -1);
+    for (size_t v = 0; v < labels.size(); ++v) {
+        int &id = renumber[labels[v]];
+        if (id < 0) {
+            id = this->count++;
+        }
+        this->label[v] = id;
+    }
+}
+
+std::map<int, std::set<int>> Partition::communities() const {
+    std::map<int, std::set<int>> clusterMap;
+    for (size_t v = 0; v < this->label.size(); ++v) {
+        clusterMap[this->label[v]].insert(v);
+    }
+    return clusterMap;
+}
@@ -0,0 +1,45 @@
+/**
+ * @brief header file for Partition class declaration
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include <map>
+#include <set>
+#include <vector>
+
+/**
+ * @brief The Partition class is the result of a community detection: the community label of every
+ * vertex and the modularity of the partition in the original graph
+ */
+class Partition {
+private:
+    std::vector<int> label; // community of each vertex, numbered in order of the first vertex
+    int count = 0; // number of communities
+    float q = -1; // modularity
+
+public:
+    Partition() = default;
+    /**
+     * @brief constructor, renumbers the communities 0, 1, ... in order of their smallest vertex
+     * @param labels community of each vertex, any non-negative numbering
+     * @param modularity modularity of the partition
+     */
+    Partition(const std::vector<int> &labels, float modularity);
+
+    const std::vector<int> &labels() const { return label; }
+    int community(int vertex) const { return label[vertex]; }
+    int numCommunities() const { return count; }
+    int numVertices() const { return label.size(); }
+    float modularity() const { return q; }
+    /**
+     * @brief group the vertices by community
+     * @return map<community, vertices of the community>
+     */
+    std::map<int, std::set<int>> communities() const;
+};
+
+#endif //PARTITION_H
@@ -0,0 +1,80 @@
+/**
+ * @brief source file for SourceScheduler class implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "SourceScheduler.h"
+
+SourceScheduler::SourceScheduler(const std::vector<unsigned int> &sources, const std::vector<uint64_t> &costs,
+                                 unsigned int numWorkers) : queues(numWorkers > 0 ? numWorkers : 1) {
+    // deal the sources round-robin so every worker starts on one of the most expensive sources
+    for (size_t i = 0; i < sources.size(); ++i) {
+        WorkQueue &queue = this->queues[i % this->queues.size()];
+        queue.sources.push_back(sources[i]);
+        queue.costs.push_back(costs[i]);
+        queue.remainingCost += costs[i];
+    }
+    for (auto &queue : this->queues) {
+        queue.tail = queue.sources.size();
+    }
+}
+
+bool SourceScheduler::next(unsigned int worker, std::vector<unsigned int> &chunk) {
+    chunk.clear();
+    WorkQueue &own = this->queues[worker];
+    {
+        std::lock_guard<std::mutex> guard(own.lock);
+        // take about a quarter of the remaining cost, at least one source:
+        // expensive sources at the front go out one at a time, cheap ones in larger batches
+        uint64_t target = own.remainingCost / 4;
+        uint64_t taken = 0;
+        while (own.head < own.tail && (chunk.empty() || taken < target)) {
+            taken += own.costs[own.head];
+            chunk.push_back(own.sources[own.head]);
+            ++own.head;
+        }
+        own.remainingCost -= taken;
+    }
+    if (!chunk.empty()) {
+        return true;
+    }
+
+    // own deque is empty: steal from the other deques, fullest first
+    while (true) {
+        unsigned int victim = worker;
+        uint64_t most = 0;
+        for (unsigned int q = 0; q < this->queues.size(); ++q) {
+            if (q == worker) {
+                continue;
+            }
+            std::lock_guard<std::mutex> guard(this->queues[q].lock);
+            if (this->queues[q].head < this->queues[q].tail && this->queues[q].remainingCost >= most) {
+                most = this->queues[q].remainingCost;
+                victim = q;
+            }
+        }
+        if (victim == worker) {
+            return false;
+        }
+        if (steal(victim, chunk)) {
+            return true;
+        }
+        // the victim was drained in between, look again
+    }
+}
+
+bool SourceScheduler::steal(unsigned int victim, std::vector<unsigned int> &chunk) {
+    WorkQueue &queue = this->queues[victim];
+    std::lock_guard<std::mutex> guard(queue.lock);
+    // take half of the remaining cost from the cheap end of the deque, at least one source
+    uint64_t target = queue.remainingCost / 2;
+    uint64_t taken = 0;
+    while (queue.head < queue.tail && (chunk.empty() || taken < target)) {
+        --queue.tail;
+        taken += queue.costs[queue.tail];
+        chunk.push_back(queue.sources[queue.tail]);
+    }
+    queue.remainingCost -= taken;
+    return !chunk.empty();
+}
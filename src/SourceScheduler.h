@@ -0,0 +1,63 @@
+/**
+ * @brief header file for SourceScheduler class declaration
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef SOURCESCHEDULER_H
+#define SOURCESCHEDULER_H
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief The SourceScheduler class hands out BFS sources to worker threads with work stealing.
+ * Sources are dealt round-robin to one deque per worker in the order they are given (most
+ * expensive first). A worker takes cost-sized chunks from the front of its own deque and, once it
+ * is empty, steals half of the remaining cost from the back of the fullest other deque.
+ */
+class SourceScheduler {
+    /**
+     * @brief The WorkQueue struct is the deque of one worker, guarded by its own mutex
+     */
+    struct WorkQueue
+    {
+        std::vector<unsigned int> sources; // sources dealt to the worker, most expensive first
+        std::vector<uint64_t> costs; // estimated cost of each source
+        size_t head = 0; // next source taken by the owner
+        size_t tail = 0; // one past the next source taken by a thief
+        uint64_t remainingCost = 0; // sum of costs in [head, tail)
+        std::mutex lock;
+    };
+
+private:
+    std::vector<WorkQueue> queues;
+
+    /**
+     * @brief take sources from the back of a victim's deque
+     * @param victim index of the deque to steal from
+     * @param chunk receives the stolen sources
+     * @return true if anything was stolen
+     */
+    bool steal(unsigned int victim, std::vector<unsigned int> &chunk);
+
+public:
+    /**
+     * @brief constructor
+     * @param sources source vertices sorted by decreasing cost
+     * @param costs estimated BFS cost of each source, parallel to sources
+     * @param numWorkers number of worker threads
+     */
+    SourceScheduler(const std::vector<unsigned int> &sources, const std::vector<uint64_t> &costs,
+                    unsigned int numWorkers);
+    /**
+     * @brief get the next chunk of sources for a worker
+     * @param worker index of the calling worker
+     * @param chunk cleared and filled with the sources to process
+     * @return false once every deque is empty
+     */
+    bool next(unsigned int worker, std::vector<unsigned int> &chunk);
+};
+
+#endif //SOURCESCHEDULER_H
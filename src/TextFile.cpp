@@ -0,0 +1,71 @@
+/**
+ * @brief source file for the text file reading functions implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "TextFile.h"
+#include <algorithm>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool readTextFile(const std::string &path, const std::function<void(std::string_view)> &consume) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return false;
+    }
+    size_t size = info.st_size;
+    void *data = MAP_FAILED;
+    if (S_ISREG(info.st_mode) && size > 0) {
+        data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED) {
+        // pipes and other files that cannot be mapped are streamed
+        std::ifstream in(path, std::ios::binary);
+        return in && readTextStream(in, consume);
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+    consume(std::string_view(static_cast<const char *>(data), size));
+    munmap(data, size);
+    return true;
+}
+
+bool readTextStream(std::istream &in, const std::function<void(std::string_view)> &consume) {
+    // read blocks up to the end, doubling the buffer whenever it is full
+    std::string buffer(1 << 16, '\0');
+    size_t size = 0;
+    while (in) {
+        if (size == buffer.size()) {
+            buffer.resize(2 * buffer.size());
+        }
+        in.read(&buffer[size], buffer.size() - size);
+        size += in.gcount();
+    }
+    if (in.bad()) {
+        return false;
+    }
+    buffer.resize(size);
+    consume(buffer);
+    return true;
+}
+
+std::vector<std::string_view> splitLines(std::string_view text, size_t parts) {
+    std::vector<std::string_view> chunks;
+    for (size_t begin = 0; begin < text.size();) {
+        size_t end = std::max(begin + 1, text.size() * (chunks.size() + 1) / parts);
+        end = end >= text.size() ? text.size() : text.find('\n', end - 1);
+        end = end == std::string_view::npos ? text.size() : end + (end < text.size());
+        chunks.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+    return chunks;
+}
@@ -0,0 +1,54 @@
+/**
+ * @brief header file for the text file reading functions declaration
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef TEXTFILE_H
+#define TEXTFILE_H
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief hand the whole content of a file to consume; a regular file is memory mapped, pipes and other
+ * files that cannot be mapped are streamed with readTextStream
+ * @param path path of the file
+ * @param consume called once with the content, which is only valid during the call
+ * @return false if the file cannot be opened or read
+ */
+bool readTextFile(const std::string &path, const std::function<void(std::string_view)> &consume);
+
+/**
+ * @brief read a stream up to its end into a buffer that doubles whenever it is full, then hand it to consume
+ * @param in stream, e.g. std::cin
+ * @param consume called once with the content, which is only valid during the call
+ * @return false if reading failed
+ */
+bool readTextStream(std::istream &in, const std::function<void(std::string_view)> &consume);
+
+/**
+ * @brief cut text in about equal parts that each end after a newline, for parsing on several threads
+ * @param text text to cut
+ * @param parts number of parts wanted; fewer are returned when the lines are too long
+ * @return the parts in order, empty for empty text
+ */
+std::vector<std::string_view> splitLines(std::string_view text, size_t parts);
+
+/**
+ * @brief take the next line of text, without its newline
+ * @param text text left to read, the line and its newline are removed from it
+ * @return the line
+ */
+inline std::string_view nextLine(std::string_view &text) {
+    size_t end = text.find('\n');
+    std::string_view line = text.substr(0, end);
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    return line;
+}
+
+#endif //TEXTFILE_H
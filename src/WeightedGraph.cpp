@@ -0,0 +1,130 @@
+/**
+ * @brief source file for WeightedGraph struct implementation
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#include "WeightedGraph.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <numeric>
+
+WeightedGraph::WeightedGraph(const CSRGraph &graph) : offsets(1, 0), loops(graph.numVertices(), 0) {
+    // a self loop sits twice in its row
+    for (uint32_t v = 0; v < graph.numVertices(); ++v) {
+        for (uint32_t j = graph.offsets()[v]; j < graph.offsets()[v + 1]; ++j) {
+            uint32_t w = graph.neighbors()[j];
+            if (w == v) {
+                this->loops[v] += 0.5;
+            } else {
+                this->neighbors.push_back(w);
+                this->weights.push_back(1);
+            }
+        }
+        this->offsets.push_back(this->neighbors.size());
+    }
+}
+
+double WeightedGraph::degree(uint32_t v) const {
+    double k = 2 * this->loops[v];
+    for (uint32_t j = this->offsets[v]; j < this->offsets[v + 1]; ++j) {
+        k += this->weights[j];
+    }
+    return k;
+}
+
+void groupMembers(const std::vector<uint32_t> &group, uint32_t count, std::vector<uint32_t> &start,
+                  std::vector<uint32_t> &members) {
+    start.assign(count + 1, 0);
+    for (uint32_t g : group) {
+        ++start[g + 1];
+    }
+    std::partial_sum(start.begin(), start.end(), start.begin());
+    members.resize(group.size());
+    std::vector<uint32_t> fill(start.begin(), start.end() - 1);
+    for (uint32_t i = 0; i < group.size(); ++i) {
+        members[fill[group[i]]++] = i;
+    }
+}
+
+WeightedGraph WeightedGraph::aggregate(std::vector<uint32_t> &community, unsigned int threads) const {
+    uint32_t n = numNodes();
+    std::vector<uint32_t> renumber(n, UINT32_MAX);
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        uint32_t &id = renumber[community[i]];
+        if (id == UINT32_MAX) {
+            id = count++;
+        }
+        community[i] = id;
+    }
+    std::vector<uint32_t> start, members;
+    groupMembers(community, count, start, members);
+
+    // cut the communities in blocks of about the same number of members; each block builds its rows
+    // on its own, then the rows are put together in community order
+    struct Block {
+        std::vector<uint32_t> neighbors;
+        std::vector<double> weights;
+        std::vector<uint32_t> rowEnd; // end of the row of each community of the block
+    };
+    size_t numBlocks = std::min<size_t>(count, threads == 1 ? 1 : threads * 8);
+    std::vector<uint32_t> blockStart(numBlocks + 1, count);
+    for (size_t b = 0; b < numBlocks; ++b) {
+        blockStart[b] = std::lower_bound(start.begin(), start.end() - 1, n * b / numBlocks) - start.begin();
+    }
+    std::vector<Block> blocks(numBlocks);
+    std::vector<std::vector<double>> neighborWeight(threads); // per thread, all 0 between communities
+
+    WeightedGraph next;
+    next.loops.assign(count, 0);
+    parallelFor(numBlocks, threads, [&](size_t begin, size_t end, unsigned int worker) {
+        std::vector<double> &weightTo = neighborWeight[worker];
+        weightTo.resize(count, 0);
+        std::vector<uint32_t> touched;
+        for (size_t b = begin; b < end; ++b) {
+            Block &block = blocks[b];
+            for (uint32_t c = blockStart[b]; c < blockStart[b + 1]; ++c) {
+                touched.clear();
+                for (uint32_t k = start[c]; k < start[c + 1]; ++k) {
+                    uint32_t i = members[k];
+                    next.loops[c] += this->loops[i];
+                    for (uint32_t j = this->offsets[i]; j < this->offsets[i + 1]; ++j) {
+                        uint32_t other = community[this->neighbors[j]];
+                        if (other == c) {
+                            next.loops[c] += this->weights[j] / 2; // seen from both ends
+                            continue;
+                        }
+                        if (weightTo[other] == 0) {
+                            touched.push_back(other);
+                        }
+                        weightTo[other] += this->weights[j];
+                    }
+                }
+                for (uint32_t other : touched) {
+                    block.neighbors.push_back(other);
+                    block.weights.push_back(weightTo[other]);
+                    weightTo[other] = 0;
+                }
+                block.rowEnd.push_back(block.neighbors.size());
+            }
+        }
+    }, 1);
+
+    std::vector<size_t> base(numBlocks + 1, 0);
+    for (size_t b = 0; b < numBlocks; ++b) {
+        base[b + 1] = base[b] + blocks[b].neighbors.size();
+        for (uint32_t end : blocks[b].rowEnd) {
+            next.offsets.push_back(base[b] + end);
+        }
+    }
+    next.neighbors.resize(base.back());
+    next.weights.resize(base.back());
+    parallelFor(numBlocks, threads, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t b = begin; b < end; ++b) {
+            std::copy(blocks[b].neighbors.begin(), blocks[b].neighbors.end(), next.neighbors.begin() + base[b]);
+            std::copy(blocks[b].weights.begin(), blocks[b].weights.end(), next.weights.begin() + base[b]);
+        }
+    }, 1);
+    return next;
+}
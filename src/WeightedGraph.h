@@ -0,0 +1,57 @@
+/**
+ * @brief header file for WeightedGraph struct declaration
+ * @author Peter Sun
+ * @date 4-5-2021
+ * @version 1.0
+ */
+#ifndef WEIGHTEDGRAPH_H
+#define WEIGHTEDGRAPH_H
+
+#include <cstdint>
+#include <vector>
+#include "CSRGraph.h"
+
+/**
+ * @brief The WeightedGraph struct is the weighted graph of one level of a multilevel modularity method:
+ * the neighbors of node v are neighbors[offsets[v] .. offsets[v + 1]) with the parallel weights, and the
+ * edges inside node v weigh loops[v] in total. Node v of the next level is a community of this one.
+ */
+struct WeightedGraph {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> neighbors;
+    std::vector<double> weights;
+    std::vector<double> loops;
+
+    WeightedGraph() : offsets(1, 0) {}
+    /**
+     * @brief the graph itself with unit weights
+     * @param graph graph
+     */
+    explicit WeightedGraph(const CSRGraph &graph);
+
+    uint32_t numNodes() const { return loops.size(); }
+    /**
+     * @brief weighted degree of a node, the loops count twice
+     */
+    double degree(uint32_t v) const;
+    /**
+     * @brief collapse communities into the nodes of the next level; the rows of the communities are
+     * built on several threads, in blocks of about the same number of members
+     * @param community community of each node, renumbered 0..count-1 in order of their first node
+     * @param threads number of threads
+     * @return graph of the next level, node c is community c, the same for any number of threads
+     */
+    WeightedGraph aggregate(std::vector<uint32_t> &community, unsigned int threads = 1) const;
+};
+
+/**
+ * @brief bucket the nodes by group with a counting sort
+ * @param group group of each node, less than count
+ * @param count number of groups
+ * @param start receives count + 1 offsets, the members of group g are members[start[g] .. start[g + 1])
+ * @param members receives the nodes by group, in node order within a group
+ */
+void groupMembers(const std::vector<uint32_t> &group, uint32_t count, std::vector<uint32_t> &start,
+                  std::vector<uint32_t> &members);
+
+#endif //WEIGHTEDGRAPH_H
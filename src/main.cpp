@@ -5,98 +5,288 @@
  * @version 1.0
  */
 #include "GVGraph.h"
+#include "EdgeListFile.h"
+#include "GraphSnapshot.h"
+#include "IntegerGraphFile.h"
+#include "Louvain.h"
+#include "Leiden.h"
+#include "LabelPropagation.h"
+#include "CommandLine.h"
+#include <climits>
 #include <iostream>
+#include <stdexcept>
 //#define DEBUG 1
-string trim(const string& str);
-std::vector<std::string> split(const std::string& s, char delimiter);
-// Declare function for loading input file
-vector<Edge> loadInputFile(string fileName);
+
+static const char *usage = "usage: social-graph [input file] [output file] [--threads N] [--recompute] "
+        "[--sample K [--seed S]] [--bfs topdown|bitparallel|hybrid] [--dendrogram FILE] [--patience K] "
+        "[--target-communities K] [--time-budget SECONDS] [--removal-budget N] "
+        "[--engine gn|louvain|leiden|lpa] [--format edgelist|snap|metis|mm] [--save-snapshot FILE]";
+
+//options that take a value
+static const set<string> valueOptions = {"--threads", "--sample", "--seed", "--bfs", "--dendrogram", "--patience",
+        "--target-communities", "--time-budget", "--removal-budget", "--engine", "--format", "--save-snapshot"};
+
 /**
  * @brief Load file of the social network connections, create a GVGraph object, and then
  * compute community clusters in the GVGraph object
+ * usage: social-graph [input file] [output file] [--threads N] [--recompute] [--sample K [--seed S]]
+ *        [--bfs topdown|bitparallel|hybrid] [--engine gn|louvain|leiden|lpa] [--format edgelist|snap|metis|mm]
+ * @param argc number of command line arguments
+ * @param argv input file (default data/put_data_here.txt, - reads the standard input), output file (default output.txt)
+ *        and options: --threads N computes betweenness on N threads (0 = all hardware threads),
+ *        --recompute recomputes the betweenness of the affected component after every edge removal,
+ *        --sample K approximates betweenness from K sampled sources, --seed S seeds the sampling
+ *        (and the label propagation order),
+ *        --bfs selects the BFS kernel of the betweenness computation, --dendrogram FILE writes the
+ *        hierarchy of splits in binary form, --patience K, --target-communities K, --time-budget SECONDS
+ *        and --removal-budget N stop the edge removal early, --engine louvain, leiden or lpa detects the
+ *        communities with Louvain, Leiden or label propagation instead of Girvan-Newman (--engine gn),
+ *        --save-snapshot FILE writes the graph in binary form; a snapshot can be given as the input file,
+ *        --format snap, metis or mm reads a SNAP edge list, METIS graph or Matrix Market file with integer
+ *        vertex ids instead of the "A - B" edge list (--format edgelist)
  * @return 0 if successful, 1 if there's an error
  */
-int main()
+int main(int argc, char* argv[])
 {
-    //Load file of social network connections into a vector<pair<string, string>>
-    vector<Edge> edgeList = loadInputFile("data/put_data_here.txt");
-    //Create a GVGraph object of a boost BGL undirected adjacency list
-    GVGraph girvan_newman = GVGraph(edgeList);
-
-    pair<Graph, float> gvResult = girvan_newman.detectCommunities();
-    float modularity = gvResult.second;
-    Graph communities = gvResult.first;;
-
-    map<int, int> subClusters;
-    int nclusters = connected_components(communities, make_assoc_property_map(subClusters));
-
-    cout <<"*** "<< nclusters << " communities have been detected for "
-        << num_vertices(communities) << " vertices ***" << endl;
-
-    cout << "   - modularity is " << modularity << endl;
-    cout << "   - results are in output.txt" << endl;
-
-    ofstream outputStream("./output.txt");
-    map<int, set<int>> communityMap = girvan_newman.convertMap(subClusters);
-    for (auto c: communityMap) {
-        outputStream << "Community " << c.first << endl;
-        for (auto node: c.second) {
-            outputStream << girvan_newman.node_name(node) << endl;
+    string inputFile = "data/put_data_here.txt";
+    string outputFile = "output.txt";
+    unsigned int threads = 1;
+    bool recompute = false;
+    size_t sample = 0;
+    uint64_t seed = 5489;
+    BFSKernel kernel = BFSKernel::TopDown;
+    string dendrogramFile;
+    string snapshotFile;
+    string format = "edgelist";
+    StopPolicy stopPolicy;
+    string engine = "gn";
+    vector<string> positional;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (valueOptions.count(arg) > 0 && i + 1 == argc)
+        {
+            cout << "Missing value for " << arg << endl << usage << endl;
+            return 1;
+        }
+        try
+        {
+            if (arg == "--threads")
+            {
+                threads = parseCount(argv[++i], UINT_MAX);
+            }
+            else if (arg == "--recompute")
+            {
+                recompute = true;
+            }
+            else if (arg == "--sample")
+            {
+                sample = parseCount(argv[++i]);
+            }
+            else if (arg == "--seed")
+            {
+                seed = parseCount(argv[++i]);
+            }
+            else if (arg == "--bfs")
+            {
+                string name = argv[++i];
+                if (name == "topdown")
+                {
+                    kernel = BFSKernel::TopDown;
+                }
+                else if (name == "bitparallel")
+                {
+                    kernel = BFSKernel::BitParallel;
+                }
+                else if (name == "hybrid")
+                {
+                    kernel = BFSKernel::DirectionOptimizing;
+                }
+                else
+                {
+                    cout << "Unknown BFS kernel " << name << endl;
+                    return 1;
+                }
+            }
+            else if (arg == "--engine")
+            {
+                engine = argv[++i];
+                if (engine != "gn" && engine != "louvain" && engine != "leiden" && engine != "lpa")
+                {
+                    cout << "Unknown engine " << engine << endl;
+                    return 1;
+                }
+            }
+            else if (arg == "--patience")
+            {
+                stopPolicy.patience = parseCount(argv[++i]);
+            }
+            else if (arg == "--target-communities")
+            {
+                stopPolicy.targetCommunities = parseCount(argv[++i]);
+            }
+            else if (arg == "--time-budget")
+            {
+                stopPolicy.timeBudget = parseSeconds(argv[++i]);
+            }
+            else if (arg == "--removal-budget")
+            {
+                stopPolicy.removalBudget = parseCount(argv[++i]);
+            }
+            else if (arg == "--dendrogram")
+            {
+                dendrogramFile = argv[++i];
+            }
+            else if (arg == "--format")
+            {
+                format = argv[++i];
+                IntegerGraphFile::Format integerFormat;
+                if (format != "edgelist" && !IntegerGraphFile::formatByName(format, integerFormat))
+                {
+                    cout << "Unknown format " << format << endl;
+                    return 1;
+                }
+            }
+            else if (arg == "--save-snapshot")
+            {
+                snapshotFile = argv[++i];
+            }
+            else if (arg.rfind("--", 0) == 0)
+            {
+                cout << "Unknown option " << arg << endl;
+                return 1;
+            }
+            else
+            {
+                positional.push_back(arg);
+            }
+        }
+        catch (const logic_error &)
+        {
+            //parseCount and parseSeconds throw invalid_argument or out_of_range
+            cout << "Invalid value " << argv[i] << " for " << arg << endl << usage << endl;
+            return 1;
         }
     }
-    outputStream.close();
-}
+    if (engine != "gn" && (recompute || !dendrogramFile.empty()))
+    {
+        cout << "--recompute and --dendrogram only apply to --engine gn" << endl << usage << endl;
+        return 1;
+    }
+    if (positional.size() > 0)
+    {
+        inputFile = positional[0];
+    }
+    if (positional.size() > 1)
+    {
+        outputFile = positional[1];
+    }
 
-string trim(const string& str)
-{
-    size_t first = str.find_first_not_of(' ');
-    if (string::npos == first)
+    //Load file of social network connections, the names are interned while the file is parsed;
+    //the integer formats keep their ids and a snapshot written by --save-snapshot is loaded as it is
+    IntegerGraphFile::Format integerFormat = IntegerGraphFile::Format::SNAP;
+    bool fromIntegers = IntegerGraphFile::formatByName(format, integerFormat);
+    EdgeListFile edgeFile;
+    IntegerGraphFile integerFile(integerFormat);
+    GraphSnapshot snapshot;
+    bool fromStdin = inputFile == "-";
+    bool fromSnapshot = !fromStdin && GraphSnapshot::isSnapshot(inputFile);
+    edgeFile.setNumThreads(threads);
+    integerFile.setNumThreads(threads);
+    bool loaded;
+    if (fromSnapshot)
     {
-        return str;
+        loaded = snapshot.load(inputFile);
     }
-    size_t last = str.find_last_not_of(' ');
-    return str.substr(first, (last - first + 1));
-}
+    else if (fromIntegers)
+    {
+        loaded = fromStdin ? integerFile.load(cin) : integerFile.load(inputFile);
+    }
+    else
+    {
+        loaded = fromStdin ? edgeFile.load(cin) : edgeFile.load(inputFile);
+    }
+    if (!loaded)
+    {
+        cout << "Fail to open the file." << endl;
+        return 1;
+    }
+    //Create a GVGraph object from the snapshot, the integer ids, or the interned names and edges
+    GVGraph girvan_newman = fromSnapshot
+            ? GVGraph(std::move(snapshot.graph()), std::move(snapshot.vertexNames()))
+            : fromIntegers
+            ? GVGraph(CSRGraph(integerFile.numVertices(), integerFile.edgeList()), integerFile.vertexNames())
+            : GVGraph(edgeFile.vertexNames(), edgeFile.edgeList());
+    //Write the snapshot before any detection runs, so a later run can skip the parse even if this one is
+    //stopped
+    if (!snapshotFile.empty())
+    {
+        if (!girvan_newman.writeSnapshot(snapshotFile))
+        {
+            cout << "Fail to write the snapshot." << endl;
+            return 1;
+        }
+        cout << "Graph snapshot is in " << snapshotFile << endl;
+    }
+    girvan_newman.setNumThreads(threads);
+    girvan_newman.setRecomputeBetweeness(recompute);
+    girvan_newman.setBetweenessSampling(sample, seed);
+    girvan_newman.setBFSKernel(kernel);
+    girvan_newman.setStopPolicy(stopPolicy);
 
-std::vector<std::string> split(const std::string& s, char delimiter)
-{
-    std::vector<std::string> tokens;
-    std::string token;
-    std::istringstream tokenStream(s);
-    while (std::getline(tokenStream, token, delimiter))
+    Partition communities;
+    if (engine == "louvain")
     {
-        tokens.push_back(token);
+        Louvain louvain(girvan_newman.getCSR());
+        communities = louvain.run();
+    }
+    else if (engine == "leiden")
+    {
+        Leiden leiden(girvan_newman.getCSR());
+        leiden.setNumThreads(threads);
+        communities = leiden.run();
+    }
+    else if (engine == "lpa")
+    {
+        LabelPropagation propagation(girvan_newman.getCSR());
+        propagation.setNumThreads(threads);
+        propagation.setSeed(seed);
+        communities = propagation.run();
+    }
+    else
+    {
+        communities = girvan_newman.detectCommunities();
     }
-    return tokens;
-}
 
-vector<Edge> loadInputFile(string fileName)
-{
-    string line;
-    ifstream graphFile(fileName);
-    vector<Edge> edgeList;
+    cout <<"*** "<< communities.numCommunities() << " communities have been detected for "
+        << communities.numVertices() << " vertices ***" << endl;
 
-    if (graphFile.is_open())
+    cout << "   - modularity is " << communities.modularity() << endl;
+    if (girvan_newman.getBetweenessErrorBound() > 0)
+    {
+        cout << "   - betweenness sampled from " << sample << " sources, within +/- "
+             << girvan_newman.getBetweenessErrorBound() << " at 95% confidence" << endl;
+    }
+    cout << "   - results are in " << outputFile << endl;
+    if (!dendrogramFile.empty())
     {
-        // Get number of edges
-        getline(graphFile, line);
-        trim(line);
-        int numOfEdges = stoi(line);
-        for (int i = 0; i < numOfEdges; i++)
+        ofstream dendrogramStream(dendrogramFile, ios::binary);
+        if (!girvan_newman.getDendrogram().write(dendrogramStream))
         {
-            getline(graphFile, line);
-            line = trim(line);
-            vector<string> tmp = split(line, '-');
-            tmp[0] = trim(tmp[0]);
-            tmp[1] = trim(tmp[1]);
-            Edge edge = Edge(tmp[0], tmp[1]);
-            edgeList.push_back(edge);
+            cout << "Fail to write the dendrogram." << endl;
+            return 1;
         }
+        cout << "   - " << girvan_newman.getDendrogram().numLevels() << " levels of splits are in "
+             << dendrogramFile << endl;
     }
-    else
-    {
-        cout << "Fail to open the file." << endl;
-        exit(1);
+
+    ofstream outputStream(outputFile);
+    map<int, set<int>> communityMap = communities.communities();
+    for (auto c: communityMap) {
+        outputStream << "Community " << c.first << endl;
+        for (auto node: c.second) {
+            outputStream << girvan_newman.node_name(node) << endl;
+        }
     }
-    return edgeList;
-}
\ No newline at end of file
+    outputStream.close();
+}
@@ -1,6 +1,22 @@
 #define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() - only do this in one cpp file
 #include "catch.hpp"
 #include "../src/GVGraph.h"
+#include "../src/SourceScheduler.h"
+#include "../src/CSRGraph.h"
+#include "../src/EdgeHeap.h"
+#include "../src/ModularityTracker.h"
+#include "../src/ComponentHistory.h"
+#include "../src/DecrementalConnectivity.h"
+#include "../src/Louvain.h"
+#include "../src/Leiden.h"
+#include "../src/LabelPropagation.h"
+#include "../src/EdgeListFile.h"
+#include "../src/GraphSnapshot.h"
+#include "../src/IntegerGraphFile.h"
+#include "../src/CommandLine.h"
+#include <sstream>
+#include <fstream>
+#include <cstdio>
 TEST_CASE( "Test GVGraph", "[data]") {
     enum
     {
@@ -233,4 +249,701 @@ TEST_CASE( "Test GVGraph", "[data]") {
         }
         cout << "...passed" << endl;
     }
-}
\ No newline at end of file
+
+    SECTION("Test sampled betweenness stays within its error bound"){
+        cout << "Testing sampled betweenness" << flush;
+        GVGraph sampledGraph = GVGraph(edgeList);
+        sampledGraph.setBetweenessSampling(5, 42);
+        Graph exact = gvGraph.computeBetweeness();
+        Graph sampled = sampledGraph.computeBetweeness();
+        REQUIRE(gvGraph.getBetweenessErrorBound() == 0);
+        float bound = sampledGraph.getBetweenessErrorBound();
+        REQUIRE(bound > 0);
+        graph_traits<Graph>::edge_iterator gei, gei_end;
+        for (boost::tie(gei, gei_end) = edges(exact); gei != gei_end; ++gei)
+        {
+            auto e = boost::edge(source(*gei, exact), target(*gei, exact), sampled);
+            REQUIRE(std::abs(get(edge_weight_t(), exact, *gei) - get(edge_weight_t(), sampled, e.first)) <= bound);
+        }
+        // sampling every source is exact
+        GVGraph fullSample = GVGraph(edgeList);
+        fullSample.setBetweenessSampling(edgeList.size());
+        Graph all = fullSample.computeBetweeness();
+        for (boost::tie(gei, gei_end) = edges(exact); gei != gei_end; ++gei)
+        {
+            auto e = boost::edge(source(*gei, exact), target(*gei, exact), all);
+            REQUIRE(get(edge_weight_t(), exact, *gei) == get(edge_weight_t(), all, e.first));
+        }
+        cout << "...passed" << endl;
+    }
+    SECTION("Test bit-parallel and direction-optimizing BFS kernels match the top-down kernel"){
+        cout << "Testing bit-parallel and direction-optimizing BFS kernels" << flush;
+        Graph g1 = gvGraph.computeBetweeness();
+        for (BFSKernel kernel : {BFSKernel::BitParallel, BFSKernel::DirectionOptimizing}) {
+            GVGraph kernelGraph = GVGraph(edgeList);
+            kernelGraph.setBFSKernel(kernel);
+            Graph gk = kernelGraph.computeBetweeness();
+            graph_traits<Graph>::edge_iterator gei, gei_end;
+            for (boost::tie(gei, gei_end) = edges(g1); gei != gei_end; ++gei)
+            {
+                auto e = boost::edge(source(*gei, g1), target(*gei, g1), gk);
+                REQUIRE(get(edge_weight_t(), g1, *gei) == Approx(get(edge_weight_t(), gk, e.first)));
+            }
+        }
+        cout << "...passed" << endl;
+    }
+    SECTION("Test parallel betweenness matches the single-threaded betweenness"){
+        cout << "Testing parallel betweenness" << flush;
+        GVGraph parallelGraph = GVGraph(edgeList);
+        parallelGraph.setNumThreads(4);
+        Graph g1 = gvGraph.computeBetweeness();
+        Graph g4 = parallelGraph.computeBetweeness();
+        graph_traits<Graph>::edge_iterator gei, gei_end;
+        for (boost::tie(gei, gei_end) = edges(g1); gei != gei_end; ++gei)
+        {
+            auto e4 = boost::edge(source(*gei, g1), target(*gei, g1), g4);
+            REQUIRE(e4.second);
+            // fixed point sums do not depend on how the threads shared the sources
+            REQUIRE(get(edge_weight_t(), g1, *gei) == get(edge_weight_t(), g4, e4.first));
+        }
+        cout << "...passed" << endl;
+    }
+    SECTION("Test parallel edge removal matches the single-threaded removal on a graph full of ties"){
+        cout << "Testing parallel edge removal with ties" << flush;
+        // a 16 x 16 grid: its symmetries give many edges the same betweenness
+        vector<Edge> grid;
+        for (int r = 0; r < 16; ++r) {
+            for (int c = 0; c < 16; ++c) {
+                string v = to_string(r) + "_" + to_string(c);
+                if (c + 1 < 16) {
+                    grid.emplace_back(v, to_string(r) + "_" + to_string(c + 1));
+                }
+                if (r + 1 < 16) {
+                    grid.emplace_back(v, to_string(r + 1) + "_" + to_string(c));
+                }
+            }
+        }
+        for (BFSKernel kernel : {BFSKernel::TopDown, BFSKernel::BitParallel, BFSKernel::DirectionOptimizing}) {
+            for (bool recompute : {false, true}) {
+                GVGraph single = GVGraph(grid);
+                single.setBFSKernel(kernel);
+                single.setRecomputeBetweeness(recompute);
+                Partition expected = single.detectCommunities();
+                for (unsigned int threads : {2u, 4u}) {
+                    GVGraph parallel = GVGraph(grid);
+                    parallel.setBFSKernel(kernel);
+                    parallel.setRecomputeBetweeness(recompute);
+                    parallel.setNumThreads(threads);
+                    Partition result = parallel.detectCommunities();
+                    REQUIRE(result.labels() == expected.labels());
+                    REQUIRE(result.modularity() == expected.modularity());
+                    REQUIRE(parallel.getDendrogram().numLevels() == single.getDendrogram().numLevels());
+                }
+            }
+        }
+        cout << "...passed" << endl;
+    }
+}
+
+TEST_CASE( "Test SourceScheduler", "[scheduler]") {
+    cout << "Testing SourceScheduler" << flush;
+    vector<unsigned int> sources;
+    vector<uint64_t> costs;
+    for (unsigned int v = 0; v < 100; ++v) {
+        sources.push_back(v);
+        costs.push_back(v < 10 ? 1000 : 2);
+    }
+    SourceScheduler scheduler(sources, costs, 3);
+    vector<int> handedOut(sources.size(), 0);
+    vector<unsigned int> chunk;
+    // worker 0 drains its own deque and then steals from the others
+    while (scheduler.next(0, chunk)) {
+        REQUIRE(!chunk.empty());
+        for (auto v : chunk) {
+            handedOut[v]++;
+        }
+    }
+    REQUIRE(!scheduler.next(1, chunk));
+    REQUIRE(!scheduler.next(2, chunk));
+    for (auto count : handedOut) {
+        REQUIRE(count == 1);
+    }
+    cout << "...passed" << endl;
+}
+
+TEST_CASE( "Test CSRGraph", "[csr]") {
+    cout << "Testing CSRGraph" << flush;
+    // two triangles joined by the edge 2 - 3
+    vector<pair<uint32_t, uint32_t>> edges = {
+            {0, 1}, {1, 2}, {2, 0}, {2, 3}, {3, 4}, {4, 5}, {5, 3}
+    };
+    CSRGraph csr(6, edges);
+    REQUIRE(csr.numVertices() == 6);
+    REQUIRE(csr.numEdges() == 7);
+    REQUIRE(csr.degree(2) == 3);
+    REQUIRE(csr.degree(0) == 2);
+    for (uint32_t i = csr.offsets()[2]; i < csr.offsets()[3]; ++i) {
+        auto const &ends = csr.endpoints(csr.edgeIds()[i]);
+        REQUIRE((ends.first == 2 || ends.second == 2));
+        REQUIRE((ends.first == csr.neighbors()[i] || ends.second == csr.neighbors()[i]));
+    }
+
+    vector<int> component;
+    REQUIRE(csr.connectedComponents(component) == 1);
+    vector<char> alive(edges.size(), 1);
+    alive[3] = 0;
+    REQUIRE(csr.connectedComponents(component, &alive) == 2);
+    REQUIRE(component[0] == component[2]);
+    REQUIRE(component[3] == component[5]);
+    REQUIRE(component[2] != component[3]);
+    REQUIRE(csr.aliveDegree(2, &alive) == 2);
+    cout << "...passed" << endl;
+}
+
+TEST_CASE( "Test Girvan-Newman with recomputed betweenness", "[recompute]") {
+    cout << "Testing Girvan-Newman with recomputed betweenness" << flush;
+    // two triangles joined by the bridge C - D
+    vector<Edge> edgeList = {
+            Edge("A", "B"), Edge("B", "C"), Edge("C", "A"), Edge("C", "D"),
+            Edge("D", "E"), Edge("E", "F"), Edge("F", "D")
+    };
+    GVGraph gvGraph = GVGraph(edgeList);
+    gvGraph.setRecomputeBetweeness(true);
+    Partition result = gvGraph.detectCommunities();
+    REQUIRE(result.numCommunities() == 2);
+    REQUIRE(result.labels() == vector<int>({0, 0, 0, 1, 1, 1}));
+    REQUIRE(result.communities() == map<int, set<int>>{{0, {0, 1, 2}}, {1, {3, 4, 5}}});
+    // Q = 2 * (3/7 - (7/14)^2) for the two triangles in the original graph
+    REQUIRE(result.modularity() == Approx(6.0 / 7.0 - 0.5));
+    // static mode finds the same split
+    gvGraph.setRecomputeBetweeness(false);
+    REQUIRE(gvGraph.detectCommunities().labels() == result.labels());
+    REQUIRE(gvGraph.computeModularity(vector<int>{0, 0, 0, 1, 1, 1}) == Approx(6.0 / 7.0 - 0.5));
+    REQUIRE(gvGraph.computeModularity(map<int, set<int>>{{0, {0, 1, 2}}, {1, {3, 4, 5}}}) == Approx(6.0 / 7.0 - 0.5));
+    // a single community has Q = 0
+    REQUIRE(gvGraph.computeModularity(vector<int>(6, 0)) == Approx(0).margin(1e-6));
+    cout << "...passed" << endl;
+}
+
+TEST_CASE( "Test EdgeHeap", "[heap]") {
+    cout << "Testing EdgeHeap" << flush;
+    vector<float> keys = {3, 7, 7, 1, 5, 2};
+    vector<char> mask = {1, 1, 1, 1, 1, 0};
+    EdgeHeap heap(keys.size());
+    heap.build(keys, mask);
+    REQUIRE(heap.size() == 5);
+    REQUIRE(!heap.contains(5));
+    // equal keys come out lowest edge id first
+    REQUIRE(heap.top() == 1);
+
+    heap.update(3, 9);  // increase key
+    heap.update(1, 0);  // decrease key
+    heap.update(5, 4);  // insert
+    heap.remove(4);
+    vector<uint32_t> order;
+    while (!heap.empty()) {
+        order.push_back(heap.pop());
+    }
+    REQUIRE(order == vector<uint32_t>({3, 2, 5, 0, 1}));
+    cout << "...passed" << endl;
+}
+
+TEST_CASE( "Test ModularityTracker", "[modularity]") {
+    cout << "Testing ModularityTracker" << flush;
+    // two triangles joined by the bridge 2-3, then the triangle 3-4-5 loses vertex 5
+    vector<pair<uint32_t, uint32_t>> edges = {{0, 1}, {1, 2}, {0, 2}, {2, 3}, {3, 4}, {4, 5}, {3, 5}};
+    CSRGraph csr(6, edges);
+    ModularityTracker tracker(csr, vector<int>(6, 0));
+    REQUIRE(tracker.modularity() == Approx(0).margin(1e-9));
+
+    uint32_t triangle[] = {3, 4, 5};
+    REQUIRE(tracker.split(triangle, 3) == 1);
+    REQUIRE(tracker.numCommunities() == 2);
+    REQUIRE(tracker.modularity() == Approx(6.0 / 7.0 - 0.5));
+
+    uint32_t single[] = {5};
+    tracker.split(single, 1);
+    REQUIRE(tracker.labels() == vector<int>({0, 0, 0, 1, 1, 2}));
+    // L = 3, 1, 0 and d = 7, 5, 2 over m = 7
+    double expected = 4.0 / 7.0 - (49.0 + 25.0 + 4.0) / 196.0;
+    REQUIRE(tracker.modularity() == Approx(expected));
+    cout << "...passed" << endl;
+}
+
+TEST_CASE( "Test ComponentHistory", "[history]") {
+    cout << "Testing ComponentHistory" << flush;
+    // two triangles joined by the bridge 2-3: remove the bridge, then each triangle
+    vector<pair<uint32_t, uint32_t>> edges = {{0, 1}, {1, 2}, {0, 2}, {2, 3}, {3, 4}, {4, 5}, {3, 5}};
+    CSRGraph csr(6, edges);
+    ComponentHistory history(csr, {3, 0, 1, 2, 4, 5, 6}, {1, 4, 7});
+    REQUIRE(history.numSteps() == 3);
+    REQUIRE(history.numComponents(0) == 1);
+    REQUIRE(history.numComponents(1) == 2);
+    REQUIRE(history.numComponents(2) == 4);
+    REQUIRE(history.numComponents(3) == 6);
+    REQUIRE(history.modularity(0) == Approx(0).margin(1e-9));
+    REQUIRE(history.modularity(1) == Approx(6.0 / 7.0 - 0.5));
+    REQUIRE(history.modularity(2) == Approx(3.0 / 7.0 - 66.0 / 196.0));
+    REQUIRE(history.modularity(3) == Approx(-34.0 / 196.0));
+
+    vector<int> labels;
+    history.labels(2, labels);
+    REQUIRE(labels == vector<int>({0, 1, 2, 3, 3, 3}));
+
+    // the dendrogram: the last merge joins the two triangles at the bridge step
+    const vector<ComponentHistory::Merge> &merges = history.merges();
+    REQUIRE(merges.size() == 5);
+    REQUIRE(merges.back().step == 0);
+    REQUIRE(merges[0].step == 2);
+    REQUIRE(max(merges.back().left, merges.back().right) == 6 + 3);
+    cout << "...passed" << endl;
+}
+
+TEST_CASE( "Test DecrementalConnectivity", "[connectivity]") {
+    cout << "Testing DecrementalConnectivity" << flush;
+    // two triangles joined by the bridge 2-3, plus the isolated vertex 6
+    vector<pair<uint32_t, uint32_t>> edges = {{0, 1}, {1, 2}, {0, 2}, {2, 3}, {3, 4}, {4, 5}, {3, 5}};
+    CSRGraph csr(7, edges);
+    vector<char> alive(edges.size(), 1);
+    DecrementalConnectivity connectivity(csr, alive);
+    REQUIRE(connectivity.numComponents() == 2);
+
+    // a triangle edge is not a bridge
+    alive[4] = 0;
+    REQUIRE(!connectivity.deleteEdge(4));
+    REQUIRE(connectivity.numComponents() == 2);
+
+    // the bridge 2-3 splits the sides in two pieces of the same size, the side of 2 moves
+    alive[3] = 0;
+    REQUIRE(connectivity.deleteEdge(3));
+    vector<uint32_t> piece = connectivity.piece();
+    sort(piece.begin(), piece.end());
+    REQUIRE(piece == vector<uint32_t>({0, 1, 2}));
+    REQUIRE(connectivity.component(0) == 2);
+    REQUIRE(connectivity.component(4) == connectivity.component(3));
+    REQUIRE(connectivity.members(connectivity.component(5)).size() == 3);
+
+    // 4 now hangs off 5 only
+    alive[5] = 0;
+    REQUIRE(connectivity.deleteEdge(5));
+    REQUIRE(connectivity.piece() == vector<uint32_t>({4}));
+    REQUIRE(connectivity.numComponents() == 4);
+    vector<int> labels;
+    REQUIRE((int) csr.connectedComponents(labels, &alive) == connectivity.numComponents());
+    cout << "...passed" << endl;
+}
+
+TEST_CASE( "Test Dendrogram", "[dendrogram]") {
+    cout << "Testing Dendrogram" << flush;
+    // two triangles joined by the bridge C - D
+    vector<Edge> edgeList = {
+            Edge("A", "B"), Edge("B", "C"), Edge("C", "A"), Edge("C", "D"),
+            Edge("D", "E"), Edge("E", "F"), Edge("F", "D")
+    };
+    for (bool recompute : {false, true}) {
+        GVGraph gvGraph = GVGraph(edgeList);
+        gvGraph.setRecomputeBetweeness(recompute);
+        Partition result = gvGraph.detectCommunities();
+        const Dendrogram &dendrogram = gvGraph.getDendrogram();
+        REQUIRE(dendrogram.numLevels() > 2);
+        // every level cuts to its number of communities and its modularity
+        for (size_t i = 0; i < dendrogram.numLevels(); ++i) {
+            Partition level = dendrogram.cut(i);
+            REQUIRE(level.numCommunities() == (int) dendrogram.levels()[i].communities);
+            REQUIRE(level.modularity() == Approx(gvGraph.computeModularity(level.labels())).margin(1e-6));
+        }
+        REQUIRE(dendrogram.cut(0).numCommunities() == 1);
+        REQUIRE(dendrogram.cut(dendrogram.bestLevel()).labels() == result.labels());
+        REQUIRE(dendrogram.cutAtCommunities(2).labels() == result.labels());
+        REQUIRE(dendrogram.cutAtModularity(0.3).labels() == result.labels());
+
+        stringstream stream;
+        REQUIRE(dendrogram.write(stream));
+        Dendrogram copy;
+        REQUIRE(copy.read(stream));
+        REQUIRE(copy.numLevels() == dendrogram.numLevels());
+        REQUIRE(copy.merges().size() == dendrogram.merges().size());
+        REQUIRE(copy.cutAtCommunities(4).labels() == dendrogram.cutAtCommunities(4).labels());
+    }
+    stringstream garbage("not a dendrogram");
+    Dendrogram empty;
+    REQUIRE(!empty.read(garbage));
+    REQUIRE(empty.numLevels() == 0);
+    REQUIRE(empty.cutAtCommunities(2).numVertices() == 0);
+    REQUIRE(empty.cutAtModularity(0.3).numVertices() == 0);
+    // a header that claims more records than the stream holds is rejected
+    stringstream truncated;
+    truncated.write("GNDG", 4);
+    for (uint32_t word : {1u, 6u, 0xFFFFFFFFu, 5u}) {
+        truncated.write(reinterpret_cast<const char *>(&word), sizeof(word));
+    }
+    REQUIRE(!empty.read(truncated));
+    cout << "...passed" << endl;
+}
+
+TEST_CASE( "Test StopPolicy", "[stop]") {
+    cout << "Testing StopPolicy" << flush;
+    // two triangles joined by the bridge C - D
+    vector<Edge> edgeList = {
+            Edge("A", "B"), Edge("B", "C"), Edge("C", "A"), Edge("C", "D"),
+            Edge("D", "E"), Edge("E", "F"), Edge("F", "D")
+    };
+    for (bool recompute : {false, true}) {
+        GVGraph gvGraph = GVGraph(edgeList);
+        gvGraph.setRecomputeBetweeness(recompute);
+        StopPolicy policy;
+
+        // the bridge is the only edge of the first step
+        policy.removalBudget = 1;
+        gvGraph.setStopPolicy(policy);
+        Partition result = gvGraph.detectCommunities();
+        REQUIRE(result.labels() == vector<int>({0, 0, 0, 1, 1, 1}));
+        REQUIRE(result.modularity() == Approx(6.0 / 7.0 - 0.5));
+        REQUIRE(gvGraph.getDendrogram().numLevels() == 2);
+
+        policy = StopPolicy();
+        policy.targetCommunities = 2;
+        gvGraph.setStopPolicy(policy);
+        REQUIRE(gvGraph.detectCommunities().numCommunities() == 2);
+        REQUIRE(gvGraph.getDendrogram().levels().back().communities == 2);
+
+        // every split after the bridge lowers modularity
+        policy = StopPolicy();
+        policy.patience = 1;
+        gvGraph.setStopPolicy(policy);
+        REQUIRE(gvGraph.detectCommunities().labels() == result.labels());
+        REQUIRE(gvGraph.getDendrogram().numLevels() == 3);
+
+        // a budget that runs out during the betweeness computation removes nothing
+        policy = StopPolicy();
+        policy.timeBudget = 1e-12;
+        gvGraph.setStopPolicy(policy);
+        REQUIRE(gvGraph.detectCommunities().labels() == vector<int>(6, 0));
+        REQUIRE(gvGraph.getDendrogram().numLevels() == 1);
+        policy = StopPolicy();
+        policy.removalBudget = 1;
+        gvGraph.setStopPolicy(policy);
+        REQUIRE(gvGraph.detectCommunities().labels() == result.labels());
+    }
+    cout << "...passed" << endl;
+}
+
+TEST_CASE( "Test Louvain", "[louvain]") {
+    cout << "Testing Louvain" << flush;
+    // two triangles joined by the bridge 2-3, and a pair 6-7 on its own
+    vector<pair<uint32_t, uint32_t>> edges = {{0, 1}, {1, 2}, {0, 2}, {2, 3}, {3, 4}, {4, 5}, {3, 5}, {6, 7}};
+    CSRGraph csr(8, edges);
+    Louvain louvain(csr);
+    Partition result = louvain.run();
+    REQUIRE(result.labels() == vector<int>({0, 0, 0, 1, 1, 1, 2, 2}));
+    vector<int> labels(result.labels());
+    REQUIRE(result.modularity() == Approx(ModularityTracker(csr, labels).modularity()));
+    REQUIRE(louvain.numLevels() >= 1);
+
+    // a graph without edges keeps every vertex on its own
+    CSRGraph empty(3, {});
+    REQUIRE(Louvain(empty).run().numCommunities() == 3);
+    cout << "...passed" << endl;
+}
+
+TEST_CASE( "Test Leiden", "[leiden]") {
+    cout << "Testing Leiden" << flush;
+    vector<pair<uint32_t, uint32_t>> edges = {{0, 1}, {1, 2}, {0, 2}, {2, 3}, {3, 4}, {4, 5}, {3, 5}, {6, 7}};
+    CSRGraph csr(8, edges);
+    Leiden leiden(csr);
+    REQUIRE(leiden.run().labels() == vector<int>({0, 0, 0, 1, 1, 1, 2, 2}));
+
+    // random graph of 8 dense groups of 40 vertices with sparse links between them
+    std::mt19937 generator(7);
+    std::uniform_int_distribution<uint32_t> pick(0, 39);
+    std::uniform_int_distribution<uint32_t> group(0, 7);
+    vector<pair<uint32_t, uint32_t>> random;
+    for (int i = 0; i < 3000; ++i) {
+        uint32_t g = group(generator);
+        uint32_t h = i % 10 == 0 ? group(generator) : g;
+        random.emplace_back(g * 40 + pick(generator), h * 40 + pick(generator));
+    }
+    CSRGraph randomCSR(320, random);
+    Leiden sequential(randomCSR);
+    Partition result = sequential.run();
+    Leiden parallel(randomCSR);
+    parallel.setNumThreads(3);
+    REQUIRE(parallel.run().labels() == result.labels());
+    REQUIRE(result.modularity() > Louvain(randomCSR).run().modularity() - 0.01);
+
+    // every community is connected by its own edges
+    vector<char> inside(random.size());
+    for (size_t e = 0; e < random.size(); ++e) {
+        inside[e] = result.community(random[e].first) == result.community(random[e].second);
+    }
+    vector<int> component;
+    REQUIRE(randomCSR.connectedComponents(component, &inside) == result.numCommunities());
+    cout << "...passed" << endl;
+}
+
+TEST_CASE( "Test LabelPropagation", "[lpa]") {
+    cout << "Testing LabelPropagation" << flush;
+    // two 5-cliques joined by the edge 4-5, and the pair 10-11
+    vector<pair<uint32_t, uint32_t>> edges;
+    for (uint32_t base : {0u, 5u}) {
+        for (uint32_t i = 0; i < 5; ++i) {
+            for (uint32_t j = i + 1; j < 5; ++j) {
+                edges.emplace_back(base + i, base + j);
+            }
+        }
+    }
+    edges.emplace_back(4, 5);
+    edges.emplace_back(10, 11);
+    CSRGraph csr(13, edges);
+    for (uint64_t seed : {1, 2, 3}) {
+        LabelPropagation propagation(csr);
+        propagation.setSeed(seed);
+        Partition result = propagation.run();
+        REQUIRE(result.labels() == vector<int>({0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 2, 2, 3}));
+        vector<int> labels(result.labels());
+        REQUIRE(result.modularity() == Approx(ModularityTracker(csr, labels).modularity()));
+        REQUIRE(propagation.numRounds() >= 2);
+        // one thread gives the same labels for the same seed
+        REQUIRE(propagation.run().labels() == result.labels());
+    }
+    cout << "...passed" << endl;
+}
+
+TEST_CASE( "Test EdgeListFile", "[loader]") {
+    cout << "Testing EdgeListFile" << flush;
+    EdgeListFile file;
+    file.parse("4\n Myriel - Napoleon \nMyriel-MlleBaptistine\r\nnot an edge\nNapoleon - Myriel\n");
+    REQUIRE(file.vertexNames() == vector<string>({"Myriel", "Napoleon", "MlleBaptistine"}));
+    REQUIRE(file.edgeList() == vector<pair<uint32_t, uint32_t>>({{0, 1}, {0, 2}, {1, 0}}));
+
+    // the file is mapped and gives the same graph as the edge list constructor
+    string path = "edge_list_file_test.txt";
+    ofstream out(path);
+    out << "3\nA - B\nB - C\nC - A\n";
+    out.close();
+    REQUIRE(file.load(path));
+    std::remove(path.c_str());
+    GVGraph loaded(file.vertexNames(), file.edgeList());
+    GVGraph direct(vector<Edge>{Edge("A", "B"), Edge("B", "C"), Edge("C", "A")});
+    REQUIRE(loaded.getCSR().neighbors() == direct.getCSR().neighbors());
+    REQUIRE(loaded.node_name(2) == "C");
+    REQUIRE(!file.load("missing_edge_list_file.txt"));
+
+    // chunked parsing on several threads gives the same ids; the edge count is only a hint, so every
+    // line up to the end is read
+    string text = "500\n";
+    for (int i = 0; i < 600; ++i) {
+        text += "n" + to_string(i * 7 % 101) + " - n" + to_string(i * 13 % 97) + (i % 50 ? "\n" : "\r\n");
+    }
+    EdgeListFile sequential;
+    sequential.parse(text);
+    REQUIRE(sequential.edgeList().size() == 600);
+    for (unsigned int threads : {2u, 3u, 8u}) {
+        EdgeListFile chunked;
+        chunked.setNumThreads(threads);
+        chunked.parse(text);
+        REQUIRE(chunked.vertexNames() == sequential.vertexNames());
+        REQUIRE(chunked.edgeList() == sequential.edgeList());
+    }
+
+    // the header is optional and may be far too large
+    EdgeListFile headerless;
+    headerless.parse(text.substr(4));
+    REQUIRE(headerless.vertexNames() == sequential.vertexNames());
+    REQUIRE(headerless.edgeList() == sequential.edgeList());
+    headerless.parse("99999999999\nA - B");
+    REQUIRE(headerless.edgeList() == vector<pair<uint32_t, uint32_t>>({{0, 1}}));
+
+    // a line with an empty side is skipped and never makes an empty name
+    headerless.parse("A -\n - B\n-\nA - B\nC-\r\n");
+    REQUIRE(headerless.vertexNames() == vector<string>({"A", "B"}));
+    REQUIRE(headerless.edgeList() == vector<pair<uint32_t, uint32_t>>({{0, 1}}));
+
+    // a stream is read to its end through a growing buffer, here past its first 64KB block
+    string large;
+    for (int i = 0; i < 10000; ++i) {
+        large += "v" + to_string(i) + " - v" + to_string((i * 31 + 7) % 10000) + "\n";
+    }
+    std::istringstream stream(large);
+    EdgeListFile streamed;
+    REQUIRE(streamed.load(stream));
+    EdgeListFile parsed;
+    parsed.parse(large);
+    REQUIRE(streamed.edgeList().size() == 10000);
+    REQUIRE(streamed.vertexNames() == parsed.vertexNames());
+    REQUIRE(streamed.edgeList() == parsed.edgeList());
+
+    // names may hold a '-' when the separator is " - "
+    file.parse("Jean-Luc - Picard\nA-B\n");
+    REQUIRE(file.vertexNames() == vector<string>({"Jean-Luc", "Picard", "A", "B"}));
+    REQUIRE(file.edgeList() == vector<pair<uint32_t, uint32_t>>({{0, 1}, {2, 3}}));
+    cout << "...passed" << endl;
+}
+
+TEST_CASE( "Test GraphSnapshot", "[snapshot]") {
+    cout << "Testing GraphSnapshot" << flush;
+    vector<string> names = {"d", "b", "a", "c", "e", "f"};
+    vector<pair<uint32_t, uint32_t>> edges = {{0, 1}, {1, 2}, {2, 0}, {3, 4}, {4, 5}, {5, 3}, {0, 3}, {5, 5}};
+    GVGraph graph(names, edges);
+    const string path = "graph_snapshot_test.bin";
+
+    SECTION("round trip") {
+        REQUIRE(graph.writeSnapshot(path));
+        REQUIRE(GraphSnapshot::isSnapshot(path));
+        GraphSnapshot snapshot;
+        REQUIRE(snapshot.load(path));
+        const CSRGraph &csr = graph.getCSR();
+        REQUIRE(snapshot.graph().numVertices() == csr.numVertices());
+        REQUIRE(snapshot.graph().numEdges() == csr.numEdges());
+        REQUIRE(snapshot.graph().offsets() == csr.offsets());
+        REQUIRE(snapshot.graph().neighbors() == csr.neighbors());
+        REQUIRE(snapshot.graph().edgeIds() == csr.edgeIds());
+        for (uint32_t e = 0; e < csr.numEdges(); ++e) {
+            REQUIRE(snapshot.graph().endpoints(e) == csr.endpoints(e));
+        }
+        REQUIRE(snapshot.vertexNames() == vector<string>({"a", "b", "c", "d", "e", "f"}));
+
+        GVGraph loaded(std::move(snapshot.graph()), std::move(snapshot.vertexNames()));
+        for (int v = 0; v < 6; ++v) {
+            REQUIRE(loaded.node_name(v) == graph.node_name(v));
+        }
+        Partition expected = graph.detectCommunities();
+        Partition actual = loaded.detectCommunities();
+        REQUIRE(actual.labels() == expected.labels());
+        REQUIRE(actual.modularity() == Approx(expected.modularity()));
+    }
+
+    SECTION("damaged files are rejected") {
+        REQUIRE(graph.writeSnapshot(path));
+        std::ifstream in(path, std::ios::binary);
+        string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        GraphSnapshot snapshot;
+
+        // truncated
+        std::ofstream(path, std::ios::binary) << bytes.substr(0, bytes.size() - 1);
+        REQUIRE(!snapshot.load(path));
+        // another version
+        string versioned = bytes;
+        versioned[4] = 2;
+        std::ofstream(path, std::ios::binary) << versioned;
+        REQUIRE(GraphSnapshot::isSnapshot(path));
+        REQUIRE(!snapshot.load(path));
+        // a neighbor out of range, right after the header and the 7 offsets
+        string corrupted = bytes;
+        corrupted[24 + 7 * 4 + 3] = char(0x7f);
+        std::ofstream(path, std::ios::binary) << corrupted;
+        REQUIRE(!snapshot.load(path));
+        // a text edge list is not a snapshot
+        std::ofstream(path) << "1\na - b\n";
+        REQUIRE(!GraphSnapshot::isSnapshot(path));
+        REQUIRE(!snapshot.load(path));
+        REQUIRE(!GraphSnapshot::isSnapshot("no_such_snapshot.bin"));
+    }
+    std::remove(path.c_str());
+    cout << "...passed" << endl;
+}
+
+TEST_CASE( "Test IntegerGraphFile", "[loader]") {
+    cout << "Testing IntegerGraphFile" << flush;
+    typedef vector<pair<uint32_t, uint32_t>> Edges;
+
+    SECTION("SNAP") {
+        IntegerGraphFile file(IntegerGraphFile::Format::SNAP);
+        REQUIRE(file.parse("# FromNodeId\tToNodeId\n10\t20\n20 30 5\n% comment\n\n30 10\n7 10\r\n"));
+        REQUIRE(file.vertexIds() == vector<uint64_t>({7, 10, 20, 30}));
+        REQUIRE(file.vertexNames() == vector<string>({"7", "10", "20", "30"}));
+        REQUIRE(file.edgeList() == Edges({{1, 2}, {2, 3}, {3, 1}, {0, 1}}));
+
+        // sparse ids are numbered by sorting them, in the same order
+        REQUIRE(file.parse("5000000000 5\n5 17\n"));
+        REQUIRE(file.vertexIds() == vector<uint64_t>({5, 17, 5000000000}));
+        REQUIRE(file.edgeList() == Edges({{2, 0}, {0, 1}}));
+
+        // the same graph for any number of threads
+        string text;
+        for (int i = 0; i < 3000; ++i) {
+            text += to_string(i * 7 % 1009) + " " + to_string(i * 13 % 997) + "\n";
+        }
+        REQUIRE(file.parse(text));
+        for (unsigned int threads : {2u, 5u}) {
+            IntegerGraphFile chunked(IntegerGraphFile::Format::SNAP);
+            chunked.setNumThreads(threads);
+            REQUIRE(chunked.parse(text));
+            REQUIRE(chunked.vertexIds() == file.vertexIds());
+            REQUIRE(chunked.edgeList() == file.edgeList());
+        }
+    }
+
+    SECTION("METIS") {
+        IntegerGraphFile file(IntegerGraphFile::Format::METIS);
+        // vertex 4 has an empty line and no neighbors
+        REQUIRE(file.parse("% two triangles\n5 4\n2 3 5\n1 3\n1 2\n\n1\n"));
+        REQUIRE(file.numVertices() == 5);
+        REQUIRE(file.vertexNames() == vector<string>({"1", "2", "3", "4", "5"}));
+        REQUIRE(file.edgeList() == Edges({{0, 1}, {0, 2}, {0, 4}, {1, 2}}));
+
+        // vertex weights and edge weights are skipped
+        REQUIRE(file.parse("3 2 011\n7 2 4\n1 1 4 3 1\n1 2 1\n"));
+        REQUIRE(file.edgeList() == Edges({{0, 1}, {1, 2}}));
+
+        for (unsigned int threads : {1u, 3u}) {
+            IntegerGraphFile chunked(IntegerGraphFile::Format::METIS);
+            chunked.setNumThreads(threads);
+            REQUIRE(chunked.parse("6 7\n2 3\n1 3\n1 2 4\n3 5 6\n4 6\n4 5\n"));
+            REQUIRE(chunked.edgeList() == Edges({{0, 1}, {0, 2}, {1, 2}, {2, 3}, {3, 4}, {3, 5}, {4, 5}}));
+            GVGraph graph(CSRGraph(chunked.numVertices(), chunked.edgeList()), chunked.vertexNames());
+            Partition communities = graph.detectCommunities();
+            REQUIRE(communities.numCommunities() == 2);
+            REQUIRE(communities.labels() == vector<int>({0, 0, 0, 1, 1, 1}));
+            REQUIRE(graph.node_name(5) == "6");
+        }
+
+        REQUIRE(!file.parse("2 1\n2\n9\n")); // neighbor out of range
+        REQUIRE(file.numVertices() == 0);
+        REQUIRE(!file.parse("2 1\n2\n1\n1\n")); // more vertex lines than vertices
+        REQUIRE(!file.parse("2 1 2\n2\n1\n")); // unknown fmt
+        REQUIRE(!file.parse("% only a comment\n"));
+    }
+
+    SECTION("Matrix Market") {
+        IntegerGraphFile file(IntegerGraphFile::Format::MatrixMarket);
+        REQUIRE(file.parse("%%MatrixMarket matrix coordinate pattern symmetric\n% comment\n5 5 3\n2 1\n3 1\n4 3\n"));
+        REQUIRE(file.numVertices() == 5);
+        REQUIRE(file.edgeList() == Edges({{1, 0}, {2, 0}, {3, 2}}));
+        REQUIRE(file.parse("%%matrixmarket MATRIX Coordinate real general\n3 3 2\n1 2 0.5\n3 2 -1e3\n"));
+        REQUIRE(file.edgeList() == Edges({{0, 1}, {2, 1}}));
+
+        REQUIRE(!file.parse("%%MatrixMarket matrix array real general\n2 2\n1\n2\n3\n4\n"));
+        REQUIRE(!file.parse("%%MatrixMarket matrix coordinate pattern general\n2 2 1\n3 1\n"));
+        REQUIRE(!file.parse("1 2\n"));
+    }
+
+    IntegerGraphFile::Format format;
+    REQUIRE(IntegerGraphFile::formatByName("metis", format));
+    REQUIRE(format == IntegerGraphFile::Format::METIS);
+    REQUIRE(!IntegerGraphFile::formatByName("edgelist", format));
+    cout << "...passed" << endl;
+}
+
+TEST_CASE( "Test CommandLine", "[cli]") {
+    cout << "Testing CommandLine" << flush;
+    REQUIRE(parseCount("0") == 0);
+    REQUIRE(parseCount("4") == 4);
+    REQUIRE(parseCount("18446744073709551615") == UINT64_MAX);
+    REQUIRE(parseCount("4294967295", UINT32_MAX) == UINT32_MAX);
+    // the whole value must be digits: no trailing characters, signs, fractions or spaces
+    for (const string &text : {"", "abc", "4x", "5abc", "-1", "-3", "+2", "1.5", " 7", "7 "}) {
+        REQUIRE_THROWS_AS(parseCount(text), std::invalid_argument);
+    }
+    REQUIRE_THROWS_AS(parseCount("99999999999999999999999"), std::out_of_range);
+    REQUIRE_THROWS_AS(parseCount("4294967296", UINT32_MAX), std::out_of_range);
+
+    REQUIRE(parseSeconds("2.5") == 2.5);
+    REQUIRE(parseSeconds("0") == 0);
+    REQUIRE(parseSeconds("1e-3") == Approx(0.001));
+    for (const string &text : {"", "x", "2s", "-1", " 1", "nan", "inf"}) {
+        REQUIRE_THROWS_AS(parseSeconds(text), std::invalid_argument);
+    }
+    cout << "...passed" << endl;
+}